@@ -0,0 +1,195 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "nes.hpp"
+
+namespace {
+/// CPU bound NROM program, used when no ROM is given. The main loop mixes the common
+/// addressing modes (absolute indexed, indirect indexed, zero page, stack) with the
+/// rendering enabled, and never idles, so that every frame runs the same instructions.
+const uint8_t PROGRAM[] = {
+    // reset ($C000): wait for the PPU, enable the NMI and the rendering
+    0x78,                   // SEI
+    0xD8,                   // CLD
+    0xA2, 0xFF,             // LDX #$FF
+    0x9A,                   // TXS
+    0x2C, 0x02, 0x20,       // BIT $2002
+    0x10, 0xFB,             // BPL $C005
+    0x2C, 0x02, 0x20,       // BIT $2002
+    0x10, 0xFB,             // BPL $C00A
+    0xA9, 0x80,             // LDA #$80
+    0x8D, 0x00, 0x20,       // STA $2000
+    0xA9, 0x1E,             // LDA #$1E
+    0x8D, 0x01, 0x20,       // STA $2001
+    0xA9, 0x00,             // LDA #$00
+    0x85, 0x10,             // STA $10
+    0xA9, 0x02,             // LDA #$02
+    0x85, 0x11,             // STA $11
+    0xA0, 0x00,             // LDY #$00
+    // loop ($C023)
+    0xA2, 0x00,             // LDX #$00
+    0xBD, 0x00, 0x02,       // LDA $0200,X
+    0x71, 0x10,             // ADC ($10),Y
+    0x9D, 0x00, 0x03,       // STA $0300,X
+    0x45, 0x20,             // EOR $20
+    0x2A,                   // ROL A
+    0x85, 0x20,             // STA $20
+    0xC8,                   // INY
+    0xE8,                   // INX
+    0xD0, 0xEF,             // BNE $C025
+    0xE6, 0x21,             // INC $21
+    0x20, 0x3E, 0xC0,       // JSR $C03E
+    0x4C, 0x23, 0xC0,       // JMP $C023
+    // subroutine ($C03E)
+    0xA5, 0x21,             // LDA $21
+    0x48,                   // PHA
+    0x29, 0x0F,             // AND #$0F
+    0xAA,                   // TAX
+    0x68,                   // PLA
+    0x9D, 0x00, 0x02,       // STA $0200,X
+    0x60,                   // RTS
+    // nmi ($C049)
+    0xE6, 0x22,             // INC $22
+    0x40,                   // RTI
+};
+
+/// Build a 16KB PRG / 8KB CHR NROM image running `PROGRAM`.
+/// @return The content of the ROM file.
+std::vector<uint8_t> build_rom() {
+    std::vector<uint8_t> rom(0x10 + 0x4000 + 0x2000, 0x00);
+
+    const uint8_t header[] = { 'N', 'E', 'S', 0x1A, 0x01, 0x01 };
+    const uint8_t vectors[] = { 0x49, 0xC0, 0x00, 0xC0, 0x4B, 0xC0 };
+
+    memcpy(rom.data(), header, sizeof(header));
+    memcpy(rom.data() + 0x10, PROGRAM, sizeof(PROGRAM));
+    memcpy(rom.data() + 0x10 + 0x3FFA, vectors, sizeof(vectors));
+
+    return rom;
+}
+
+/// Result of a benchmark run.
+struct Result {
+public:
+    uint64_t instructions = 0;
+    double seconds = 0.0;
+};
+
+/// Run an emulator for the given number of frames.
+/// @param nes Emulator to run.
+/// @param frames Number of frames.
+/// @return The number of instructions executed and the elapsed time.
+Result run(cynes::NES& nes, unsigned int frames) {
+    uint64_t instructions = nes.get_instruction_count();
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (unsigned int k = 0; k < frames; k++) {
+        if (nes.step(0x00, 1)) {
+            break;
+        }
+    }
+
+    auto stop = std::chrono::steady_clock::now();
+
+    Result result;
+    result.instructions = nes.get_instruction_count() - instructions;
+    result.seconds = std::chrono::duration<double>(stop - start).count();
+
+    return result;
+}
+
+/// Benchmark a ROM and print its results.
+/// @param name Name printed for the ROM.
+/// @param create Function creating a fresh emulator running the ROM.
+/// @param frames Number of frames of each run.
+/// @param runs Number of runs, the fastest one is kept.
+template<class Factory>
+void benchmark(const char* name, Factory create, unsigned int frames, unsigned int runs) {
+    Result best;
+
+    for (unsigned int k = 0; k < runs; k++) {
+        std::unique_ptr<cynes::NES> nes = create();
+        Result result = run(*nes, frames);
+
+        if (k == 0 || result.seconds < best.seconds) {
+            best = result;
+        }
+    }
+
+    printf(
+        "%-24s %12.0f %12.2f %10.1f\n",
+        name,
+        double(best.instructions) / frames,
+        best.instructions / best.seconds / 1e6,
+        frames / best.seconds
+    );
+}
+
+void usage(const char* program) {
+    fprintf(stderr, "usage: %s [--frames N] [--runs N] [rom.nes ...]\n", program);
+}
+}
+
+int main(int argc, char** argv) {
+    unsigned int frames = 3000;
+    unsigned int runs = 5;
+
+    std::vector<const char*> paths;
+
+    for (int k = 1; k < argc; k++) {
+        if ((!strcmp(argv[k], "--frames") || !strcmp(argv[k], "--runs")) && k + 1 < argc) {
+            int value = atoi(argv[k + 1]);
+
+            if (value <= 0) {
+                usage(argv[0]);
+                return 1;
+            }
+
+            if (!strcmp(argv[k], "--frames")) {
+                frames = value;
+            } else {
+                runs = value;
+            }
+
+            k++;
+        } else if (argv[k][0] == '-') {
+            usage(argv[0]);
+            return 1;
+        } else {
+            paths.push_back(argv[k]);
+        }
+    }
+
+    printf("%-24s %12s %12s %10s\n", "rom", "instr/frame", "Minstr/s", "fps");
+
+    try {
+        if (paths.empty()) {
+            std::vector<uint8_t> rom = build_rom();
+
+            benchmark("builtin", [&]() {
+                return std::make_unique<cynes::NES>(rom.data(), rom.size());
+            }, frames, runs);
+        }
+
+        for (const char* path : paths) {
+            std::string name = path;
+            name = name.substr(name.find_last_of("/\\") + 1);
+
+            benchmark(name.c_str(), [&]() {
+                return std::make_unique<cynes::NES>(path);
+            }, frames, runs);
+        }
+    } catch (const std::exception& exception) {
+        fprintf(stderr, "%s\n", exception.what());
+        return 1;
+    }
+
+    return 0;
+}
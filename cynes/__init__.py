@@ -7,7 +7,8 @@ This package contains two sub-module:
 - `cynes.emulator` with the main `NES` class, which is a direct wrapper around the C/C++
   API. This class can be used to run an emulator in 'headless' mode, which means that
   nothing will be rendered to the screen. The content of the frame buffer can be
-  accessed nonetheless.
+  accessed nonetheless. The `VectorNES` class runs a batch of headless emulators in
+  parallel.
 - `cynes.windowed` with the `WindowedNES` class, derived from `NES`. This class is a
   simple wrapper around the base emulator providing a basic renderer and input handling
   using SDL2. The python wrapper `pysdl2` must be installed to use this class.
@@ -21,7 +22,7 @@ while not nes.should_close:
 ```
 """
 
-from cynes.emulator import NES  # type: ignore
+from cynes.emulator import NES, VectorNES, FrameFormat  # type: ignore
 
 NES_INPUT_RIGHT = 0x01
 NES_INPUT_LEFT = 0x02
@@ -36,6 +37,8 @@ __version__ = "0.1.0"
 
 __all__ = [
     "NES",
+    "VectorNES",
+    "FrameFormat",
     "NES_INPUT_RIGHT",
     "NES_INPUT_LEFT",
     "NES_INPUT_DOWN",
@@ -1,8 +1,24 @@
 # cynes - C/C++ NES emulator with Python bindings
 # Copyright (C) 2021 - 2025  Combey Theo <https://www.gnu.org/licenses/>
 
+from enum import Enum
+from typing import Any, Optional, Tuple, Union
+
 import numpy as np
-from numpy.typing import NDArray
+from numpy.typing import ArrayLike, NDArray
+
+class FrameFormat(Enum):
+    """Format of the frames returned by `step`."""
+
+    RGB = ...
+    """240x256x3 RGB colors (default)."""
+
+    PALETTE = ...
+    """240x256 palette indices.
+
+    Each pixel is stored as its 6-bit NES color code. The color emphasis bits are not
+    part of the pixels and are stored once per scanline instead (see `emphasis`).
+    """
 
 class NES:
     """The base emulator class."""
@@ -26,7 +42,7 @@ class NES:
     meaning that released button have to be explicitly removed from the bit mask
     """
 
-    def __init__(self, rom: str) -> None:
+    def __init__(self, rom: Union[str, bytes]) -> None:
         """Initialize the NES emulator.
 
         The emulator initialization can fail if the ROM file cannot be found or if the
@@ -34,8 +50,10 @@ class NES:
 
         Parameters
         ----------
-        rom: str
-            The path to the NES file containing the game data.
+        rom: str | bytes
+            Either the path to the NES file containing the game data, or the content of
+            that file as a bytes-like object (bytes, bytearray, memoryview, numpy
+            array, etc...).
         """
         ...
 
@@ -74,6 +92,71 @@ class NES:
         """
         ...
 
+    def peek(self, address: int, size: int = 1) -> NDArray[np.uint8]:
+        """Read a range of the emulator memory without side effect.
+
+        Unlike `__getitem__`, the components of the console are not ticked. Memory mapped
+        registers (0x2000 - 0x4017) are not read, the open bus value is returned instead.
+
+        Parameters
+        ----------
+        address: int
+            The first address to read from.
+        size: int, default: 1
+            The number of bytes to read.
+
+        Returns
+        -------
+        values: NDArray[np.uint8]
+            A new numpy array containing the values read.
+        """
+        ...
+
+    def poke(self, address: int, values: ArrayLike) -> None:
+        """Write a range of the emulator memory without side effect.
+
+        Unlike `__setitem__`, the components of the console are not ticked. Writes to
+        memory mapped registers and to ROM are ignored, write-protected mapper RAM is
+        written anyway.
+
+        Parameters
+        ----------
+        address: int
+            The first address to write to.
+        values: ArrayLike
+            The bytes to write.
+        """
+        ...
+
+    @property
+    def ram(self) -> NDArray[np.uint8]:
+        """Read-only view of the console RAM (2KB).
+
+        The view is updated in place by the emulator and stays valid across steps and
+        state loads. Like the other memory views, it holds a reference to the emulator.
+        """
+        ...
+
+    @property
+    def prg_ram(self) -> NDArray[np.uint8]:
+        """Read-only view of the mapper PRG RAM, usually mapped at 0x6000 - 0x7FFF."""
+        ...
+
+    @property
+    def vram(self) -> NDArray[np.uint8]:
+        """Read-only view of the mapper PPU RAM (nametables followed by the CHR RAM)."""
+        ...
+
+    @property
+    def oam(self) -> NDArray[np.uint8]:
+        """Read-only view of the object attribute memory (256 bytes)."""
+        ...
+
+    @property
+    def palette(self) -> NDArray[np.uint8]:
+        """Read-only view of the palette RAM (32 bytes)."""
+        ...
+
     def reset(self) -> None:
         """Send a reset signal to the emulator.
 
@@ -82,14 +165,66 @@ class NES:
         """
         ...
 
-    def step(self, frames: int = 1) -> NDArray[np.uint8]:
+    def step(
+        self, frames: int = 1
+    ) -> Union[NDArray[np.uint8], Tuple[NDArray[np.uint8], float, bool]]:
         """Run the emulator for the specified amount of frame.
 
+        The GIL is released while the emulator is running, allowing several emulators to
+        be stepped concurrently from different threads.
+
+        Parameters
+        ----------
+        frames: int, default: 1
+            Indicates the number of frames for which the emulator will be run.
+
+        Returns
+        -------
+        frame_buffer: NDArray[np.uint8]
+            The numpy array containing the frame buffer (shape 240x256x3), or the
+            palette indices (shape 240x256) with the `FrameFormat.PALETTE` format.
+        reward: float
+            Only returned if a reward function is attached (see `set_reward`), the
+            reward summed over the frames of the step.
+        done: bool
+            Only returned if a reward function is attached, whether or not the done
+            expression was met after any frame of the step.
+        """
+        ...
+
+    def step_into(self, out: Any, frames: int = 1) -> Optional[Tuple[float, bool]]:
+        """Run the emulator for the specified amount of frame, rendering the last frame
+        directly in the given buffer.
+
+        Unlike `step`, whose returned array is overwritten by the next step, the frame is
+        written in a buffer owned by the caller, without any intermediate copy. The
+        frame buffer, palette indices and observation returned by `step` are not updated.
+        If the emulator crashes during the step, the content of the buffer is undefined.
+
         Parameters
         ----------
+        out: Any
+            A writable, C-contiguous, uint8 buffer located in host memory, implementing
+            the buffer protocol (e.g. a numpy array) or DLPack (e.g. a CPU tensor). It
+            must have the size of a frame in the current frame format (240x256x3 or
+            240x256), or of an observation if a pipeline is attached.
         frames: int, default: 1
             Indicates the number of frames for which the emulator will be run.
 
+        Returns
+        -------
+        result: Tuple[float, bool], optional
+            The reward and done flag of the step if a reward function is attached (see
+            `step`), None otherwise.
+        """
+        ...
+
+    def to_rgb(self) -> NDArray[np.uint8]:
+        """Get the last frame as RGB colors.
+
+        With the `FrameFormat.PALETTE` format, the palette indices of the last frame are
+        converted to RGB colors on demand. Otherwise, the frame buffer is returned as is.
+
         Returns
         -------
         frame_buffer: NDArray[np.uint8]
@@ -97,6 +232,21 @@ class NES:
         """
         ...
 
+    def clone(self) -> "NES":
+        """Create a copy of the emulator.
+
+        The copy shares the read-only ROM memory with the original emulator, every other
+        component state is duplicated. Cloning is faster than a `save` / `load` round
+        trip, which makes it suited to forking an emulator many times, e.g. for tree
+        search.
+
+        Returns
+        -------
+        nes: NES
+            The copied emulator.
+        """
+        ...
+
     def save(self) -> NDArray[np.uint8]:
         """Dump the current emulator state into a save state.
 
@@ -115,7 +265,8 @@ class NES:
         """Restore the emulator state from a save state.
 
         The save state basically acts as a checkpoint that can be restored at any time
-        without corrupting the NES memory.
+        without corrupting the NES memory. The buffer must have the size of the save
+        states of the emulator.
 
         Parameters
         ----------
@@ -132,3 +283,538 @@ class NES:
         Resetting the emulator / loading a valid save-state will reset this flag.
         """
         ...
+
+    @property
+    def frame_format(self) -> FrameFormat:
+        """Format of the frames returned by `step`.
+
+        The `FrameFormat.PALETTE` format outputs one byte per pixel instead of three,
+        the RGB colors can still be obtained on demand using `to_rgb`.
+        """
+        ...
+
+    @frame_format.setter
+    def frame_format(self, value: FrameFormat) -> None: ...
+
+    @property
+    def emphasis(self) -> NDArray[np.uint8]:
+        """Color emphasis bits of each scanline of the last frame (shape 240).
+
+        Only updated with the `FrameFormat.PALETTE` format. A scanline holds the
+        emphasis bits set when its last pixel was output.
+        """
+        ...
+
+    def set_observation(
+        self,
+        width: int = 84,
+        height: int = 84,
+        crop: Tuple[int, int, int, int] = (0, 0, 0, 0),
+        grayscale: bool = True,
+        stack: int = 4,
+        max_pool: bool = True,
+        channels_first: bool = False,
+    ) -> None:
+        """Attach an observation preprocessing pipeline to the emulator.
+
+        Once attached, `step` returns stacked observations instead of frames. Each
+        step, the last frame is cropped, converted to grayscale, max-pooled with the
+        frame before it and resized using area interpolation. The last `stack`
+        processed frames are returned, oldest first. After a reset or a load, the
+        first observation fills the whole stack.
+
+        Parameters
+        ----------
+        width: int, default: 84
+            The width of the observations.
+        height: int, default: 84
+            The height of the observations.
+        crop: Tuple[int, int, int, int], default: (0, 0, 0, 0)
+            The top, bottom, left and right margins removed from the frames before
+            resizing.
+        grayscale: bool, default: True
+            Whether or not the frames are converted to grayscale (ITU-R BT.601 luma).
+            Otherwise, the three RGB channels are kept.
+        stack: int, default: 4
+            The number of stacked frames.
+        max_pool: bool, default: True
+            Whether or not the last two frames of a multi-frame step are max-pooled.
+        channels_first: bool, default: False
+            Whether or not the observations use the CHW layout (shape
+            (stack*channels)xheightxwidth) instead of the HWC one (shape heightxwidthx(stack*channels)).
+        """
+        ...
+
+    def clear_observation(self) -> None:
+        """Detach the observation preprocessing pipeline."""
+        ...
+
+    @property
+    def observation(self) -> Optional[NDArray[np.uint8]]:
+        """Last stacked observation, or None if no pipeline is attached."""
+        ...
+
+    def set_reward(self, reward: str = "", done: str = "") -> None:
+        """Attach reward and termination expressions, evaluated in C++ after every
+        frame.
+
+        Once attached, `step` also returns the reward summed over the frames of the step
+        and whether or not the done expression was met after any of them. The
+        expressions are compiled once, they use a C-like syntax over double precision
+        values:
+
+        - literals: `12`, `0x7E`, `0.5`;
+        - operators: `+ - * / %`, `& | ^` (on integer parts), `== != < <= > >=`,
+          `&& || !`;
+        - `u8(address)`, `s8(address)` and `u16(address)` read the memory without side
+          effect (see `peek`);
+        - `bcd(address, count)` decodes packed BCD bytes and `digits(address, count)`
+          decimal digits stored one per byte, most significant first;
+        - `delta(expression)` is the difference with the value of the expression after
+          the previous frame, zero after a reset or a load;
+        - `min(a, b)`, `max(a, b)`, `abs(a)` and `clip(a, low, high)`.
+
+        Parameters
+        ----------
+        reward: str, default: ""
+            The reward expression, e.g. `delta(digits(0x07DD, 6)) + delta(u8(0x0086))`.
+            An empty expression always evaluates to zero.
+        done: str, default: ""
+            The termination expression, e.g. `u8(0x075A) == 0xFF`.
+        """
+        ...
+
+    def clear_reward(self) -> None:
+        """Detach the reward and termination expressions."""
+        ...
+
+    def set_environment(
+        self,
+        frame_skip: int = 4,
+        sticky_probability: float = 0.0,
+        noop_max: int = 0,
+        seed: int = 0,
+    ) -> None:
+        """Attach an environment, applying the usual reinforcement learning policies in
+        C++: action repeat, sticky actions and random no-op starts.
+
+        Parameters
+        ----------
+        frame_skip: int, default: 4
+            The number of frames emulated per action. The reward is summed over these
+            frames, and the last two are max-pooled if an observation pipeline is
+            attached.
+        sticky_probability: float, default: 0.0
+            The probability, at each frame, of repeating the previously executed action
+            instead of the new one.
+        noop_max: int, default: 0
+            The maximum number of no-op frames emulated by `noop_reset`, the actual
+            number is drawn uniformly between 1 and `noop_max`. 0 disables no-op starts.
+        seed: int, default: 0
+            The seed of the random number generator, making the environment
+            deterministic.
+        """
+        ...
+
+    def clear_environment(self) -> None:
+        """Detach the environment."""
+        ...
+
+    def act(
+        self, action: int
+    ) -> Union[NDArray[np.uint8], Tuple[NDArray[np.uint8], float, bool]]:
+        """Execute an action through the environment.
+
+        The emulator is run for `frame_skip` frames in a single call, with the GIL
+        released.
+
+        Parameters
+        ----------
+        action: int
+            The controller state.
+
+        Returns
+        -------
+        result: Union[NDArray[np.uint8], Tuple[NDArray[np.uint8], float, bool]]
+            The same value as `step`.
+        """
+        ...
+
+    def noop_reset(self, state: Optional[NDArray[np.uint8]] = None) -> NDArray[np.uint8]:
+        """Reset the emulator, or restore a save state, followed by a random number of
+        no-op frames.
+
+        The stacked observations and the crashed flag are also cleared.
+
+        Parameters
+        ----------
+        state: NDArray[np.uint8], optional
+            A save state restored instead of sending a reset signal.
+
+        Returns
+        -------
+        frame_buffer: NDArray[np.uint8]
+            The frame buffer, palette indices or observation after the no-op frames.
+        """
+        ...
+
+    @property
+    def render_skip(self) -> bool:
+        """Only render the last frame of multi-frame steps.
+
+        When enabled, `step(frames)` skips the palette lookup and the frame buffer
+        writes of every frame but the last one. The intermediate frames are still fully
+        emulated (sprite zero hit, sprite overflow, mapper side effects, etc...), so the
+        emulation itself is not affected. Disabled by default.
+        """
+        ...
+
+    @render_skip.setter
+    def render_skip(self, value: bool) -> None: ...
+
+class VectorNES:
+    """A batch of headless emulators running the same ROM, stepped in parallel."""
+
+    def __init__(self, rom: Union[str, bytes], size: int, threads: int = 0) -> None:
+        """Initialize the NES emulators.
+
+        The emulators are stepped by a persistent pool of threads. The initialization
+        can fail if the ROM file cannot be found or if the Mapper used by the game is
+        currently unsupported.
+
+        Parameters
+        ----------
+        rom: str | bytes
+            Either the path to the NES file containing the game data, or the content of
+            that file as a bytes-like object.
+        size: int
+            The number of emulators.
+        threads: int, default: 0
+            The number of threads used to step the emulators. If zero, the number of
+            hardware threads is used.
+        """
+        ...
+
+    def __len__(self) -> int:
+        """Return the number of emulators."""
+        ...
+
+    def peek(self, address: int, size: int = 1) -> NDArray[np.uint8]:
+        """Read a range of the memory of every emulator without side effect.
+
+        See `NES.peek`.
+
+        Parameters
+        ----------
+        address: int
+            The first address to read from.
+        size: int, default: 1
+            The number of bytes to read.
+
+        Returns
+        -------
+        values: NDArray[np.uint8]
+            A new numpy array containing the values read (shape Nxsize).
+        """
+        ...
+
+    def poke(self, index: int, address: int, values: ArrayLike) -> None:
+        """Write a range of the memory of one of the emulators without side effect.
+
+        See `NES.poke`.
+
+        Parameters
+        ----------
+        index: int
+            The index of the emulator.
+        address: int
+            The first address to write to.
+        values: ArrayLike
+            The bytes to write.
+        """
+        ...
+
+    def reset(self, index: int) -> None:
+        """Send a reset signal to one of the emulators.
+
+        This also resets the crashed flag of the emulator.
+
+        Parameters
+        ----------
+        index: int
+            The index of the emulator.
+        """
+        ...
+
+    def step(
+        self, frames: int = 1
+    ) -> Union[
+        NDArray[np.uint8], Tuple[NDArray[np.uint8], NDArray[np.float64], NDArray[np.bool_]]
+    ]:
+        """Run every emulator for the specified amount of frame.
+
+        The GIL is released while the emulators are running. Crashed emulators are not
+        stepped.
+
+        Parameters
+        ----------
+        frames: int, default: 1
+            Indicates the number of frames for which the emulators will be run.
+
+        Returns
+        -------
+        frame_buffers: NDArray[np.uint8]
+            The numpy array containing the frame buffers (shape Nx240x256x3), or the
+            palette indices (shape Nx240x256) with the `FrameFormat.PALETTE` format.
+        rewards: NDArray[np.float64]
+            Only returned if reward functions are attached (see `set_reward`), the
+            read-only reward of each emulator (shape N). The reward of a crashed
+            emulator is zero.
+        dones: NDArray[np.bool_]
+            Only returned if reward functions are attached, the read-only done flag of
+            each emulator (shape N).
+        """
+        ...
+
+    def step_into(
+        self, out: Any, frames: int = 1
+    ) -> Optional[Tuple[NDArray[np.float64], NDArray[np.bool_]]]:
+        """Run every emulator for the specified amount of frame, rendering the last
+        frames directly in the given buffer.
+
+        Unlike `step`, whose returned array is overwritten by the next step, the frames
+        are written in a buffer owned by the caller, without any intermediate copy. The
+        frame buffers, palette indices and observations returned by `step` are not
+        updated. The part of the buffer belonging to a crashed emulator is left
+        untouched.
+
+        Parameters
+        ----------
+        out: Any
+            A writable, C-contiguous, uint8 buffer located in host memory, implementing
+            the buffer protocol (e.g. a numpy array) or DLPack (e.g. a CPU tensor). It
+            must hold one frame per emulator in the current frame format (Nx240x256x3 or
+            Nx240x256), or one observation per emulator if a pipeline is attached.
+        frames: int, default: 1
+            Indicates the number of frames for which the emulators will be run.
+
+        Returns
+        -------
+        result: Tuple[NDArray[np.float64], NDArray[np.bool_]], optional
+            The rewards and done flags of the step if reward functions are attached (see
+            `step`), None otherwise.
+        """
+        ...
+
+    def to_rgb(self) -> NDArray[np.uint8]:
+        """Get the last frame of every emulator as RGB colors.
+
+        With the `FrameFormat.PALETTE` format, the palette indices of the last frames
+        are converted to RGB colors on demand. Otherwise, the frame buffers are returned
+        as is.
+
+        Returns
+        -------
+        frame_buffers: NDArray[np.uint8]
+            The numpy array containing the frame buffers (shape Nx240x256x3).
+        """
+        ...
+
+    def save(self, index: int) -> NDArray[np.uint8]:
+        """Dump the current state of one of the emulators into a save state.
+
+        Parameters
+        ----------
+        index: int
+            The index of the emulator.
+
+        Returns
+        -------
+        buffer: NDArray[np.uint8]
+            The numpy array containing the dump.
+        """
+        ...
+
+    def load(self, index: int, buffer: NDArray[np.uint8]) -> None:
+        """Restore the state of one of the emulators from a save state.
+
+        This also resets the crashed flag of the emulator. The buffer must have the size
+        of the save states of the emulators.
+
+        Parameters
+        ----------
+        index: int
+            The index of the emulator.
+        buffer: NDArray[np.uint8]
+            The numpy array containing the dump.
+        """
+        ...
+
+    @property
+    def controllers(self) -> NDArray[np.uint16]:
+        """Emulators controller states.
+
+        The array contains one 16-bits register per emulator, with the same layout as
+        `NES.controller`. Its content can be modified in place.
+        """
+        ...
+
+    @property
+    def has_crashed(self) -> NDArray[np.bool_]:
+        """Indicate whether each CPU crashed after hitting an invalid op-code."""
+        ...
+
+    @property
+    def frame_format(self) -> FrameFormat:
+        """Format of the frames returned by `step`.
+
+        The `FrameFormat.PALETTE` format outputs one byte per pixel instead of three,
+        the RGB colors can still be obtained on demand using `to_rgb`.
+        """
+        ...
+
+    @frame_format.setter
+    def frame_format(self, value: FrameFormat) -> None: ...
+
+    @property
+    def emphasis(self) -> NDArray[np.uint8]:
+        """Color emphasis bits of each scanline of the last frame (shape Nx240).
+
+        Only updated with the `FrameFormat.PALETTE` format. A scanline holds the
+        emphasis bits set when its last pixel was output.
+        """
+        ...
+
+    def set_observation(
+        self,
+        width: int = 84,
+        height: int = 84,
+        crop: Tuple[int, int, int, int] = (0, 0, 0, 0),
+        grayscale: bool = True,
+        stack: int = 4,
+        max_pool: bool = True,
+        channels_first: bool = False,
+    ) -> None:
+        """Attach an observation preprocessing pipeline to every emulator.
+
+        Once attached, `step` returns stacked observations instead of frames. Each
+        step, the last frame is cropped, converted to grayscale, max-pooled with the
+        frame before it and resized using area interpolation. The last `stack`
+        processed frames are returned, oldest first. After a reset or a load, the
+        first observation fills the whole stack.
+
+        Parameters
+        ----------
+        width: int, default: 84
+            The width of the observations.
+        height: int, default: 84
+            The height of the observations.
+        crop: Tuple[int, int, int, int], default: (0, 0, 0, 0)
+            The top, bottom, left and right margins removed from the frames before
+            resizing.
+        grayscale: bool, default: True
+            Whether or not the frames are converted to grayscale (ITU-R BT.601 luma).
+            Otherwise, the three RGB channels are kept.
+        stack: int, default: 4
+            The number of stacked frames.
+        max_pool: bool, default: True
+            Whether or not the last two frames of a multi-frame step are max-pooled.
+        channels_first: bool, default: False
+            Whether or not the observations use the CHW layout (shape
+            Nx(stack*channels)xheightxwidth) instead of the HWC one (shape Nxheightxwidthx(stack*channels)).
+        """
+        ...
+
+    def clear_observation(self) -> None:
+        """Detach the observation preprocessing pipeline."""
+        ...
+
+    @property
+    def observation(self) -> Optional[NDArray[np.uint8]]:
+        """Last stacked observation, or None if no pipeline is attached."""
+        ...
+
+    def set_reward(self, reward: str = "", done: str = "") -> None:
+        """Attach reward and termination expressions to every emulator (see
+        `NES.set_reward`).
+
+        Once attached, `step` also returns the rewards and done flags of every emulator.
+        Each emulator keeps its own history for `delta`, cleared when it is reset or
+        loaded.
+
+        Parameters
+        ----------
+        reward: str, default: ""
+            The reward expression.
+        done: str, default: ""
+            The termination expression.
+        """
+        ...
+
+    def clear_reward(self) -> None:
+        """Detach the reward and termination expressions."""
+        ...
+
+    def set_environment(
+        self,
+        frame_skip: int = 4,
+        sticky_probability: float = 0.0,
+        noop_max: int = 0,
+        seed: int = 0,
+    ) -> None:
+        """Attach an environment to every emulator (see `NES.set_environment`).
+
+        The generator of each emulator is seeded with `seed` plus the index of the
+        emulator.
+        """
+        ...
+
+    def clear_environment(self) -> None:
+        """Detach the environments."""
+        ...
+
+    def act(
+        self, actions: ArrayLike
+    ) -> Union[
+        NDArray[np.uint8], Tuple[NDArray[np.uint8], NDArray[np.float64], NDArray[np.bool_]]
+    ]:
+        """Execute an action on every emulator through their environments.
+
+        Parameters
+        ----------
+        actions: ArrayLike
+            The controller state of every emulator (shape N).
+
+        Returns
+        -------
+        result: Union[NDArray[np.uint8], Tuple[NDArray[np.uint8], NDArray[np.float64], NDArray[np.bool_]]]
+            The same value as `step`.
+        """
+        ...
+
+    def noop_reset(self, index: int, state: Optional[NDArray[np.uint8]] = None) -> None:
+        """Reset one of the emulators, or restore a save state, followed by a random
+        number of no-op frames (see `NES.noop_reset`).
+
+        Parameters
+        ----------
+        index: int
+            The index of the emulator.
+        state: NDArray[np.uint8], optional
+            A save state restored instead of sending a reset signal.
+        """
+        ...
+
+    @property
+    def render_skip(self) -> bool:
+        """Only render the last frame of multi-frame steps.
+
+        When enabled, `step(frames)` skips the palette lookup and the frame buffer
+        writes of every frame but the last one. The intermediate frames are still fully
+        emulated (sprite zero hit, sprite overflow, mapper side effects, etc...), so the
+        emulation itself is not affected. Disabled by default.
+        """
+        ...
+
+    @render_skip.setter
+    def render_skip(self, value: bool) -> None: ...
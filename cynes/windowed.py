@@ -252,7 +252,7 @@ class WindowedNES(NES):
 
         frame_buffer = super().step(frames=frames)
 
-        self._context.render_frame(frame_buffer)
+        self._context.render_frame(self.to_rgb())
         self.controller = previous_state
 
         return frame_buffer
@@ -18,7 +18,8 @@ constexpr uint16_t PERIOD_DMC_TABLE[0x10] = {
 };
 
 
-cynes::APU::APU(NES& nes)
+template<class MapperType>
+cynes::APU<MapperType>::APU(NESCore<MapperType>& nes)
     : _nes{nes}
     , _latch_cycle{false}
     , _delay_dma{0x00}
@@ -49,7 +50,40 @@ cynes::APU::APU(NES& nes)
     std::memset(_channel_halted, false, 4);
 }
 
-void cynes::APU::power() {
+template<class MapperType>
+cynes::APU<MapperType>::APU(NESCore<MapperType>& nes, const APU& other)
+    : _nes{nes}
+    , _latch_cycle{other._latch_cycle}
+    , _delay_dma{other._delay_dma}
+    , _address_dma{other._address_dma}
+    , _pending_dma{other._pending_dma}
+    , _open_bus{other._open_bus}
+    , _frame_counter_clock{other._frame_counter_clock}
+    , _delay_frame_reset{other._delay_frame_reset}
+    , _channels_counters{}
+    , _channel_enabled{}
+    , _channel_halted{}
+    , _step_mode{other._step_mode}
+    , _inhibit_frame_interrupt{other._inhibit_frame_interrupt}
+    , _send_frame_interrupt{other._send_frame_interrupt}
+    , _delta_channel_remaining_bytes{other._delta_channel_remaining_bytes}
+    , _delta_channel_sample_length{other._delta_channel_sample_length}
+    , _delta_channel_period_counter{other._delta_channel_period_counter}
+    , _delta_channel_period_load{other._delta_channel_period_load}
+    , _delta_channel_bits_in_buffer{other._delta_channel_bits_in_buffer}
+    , _delta_channel_should_loop{other._delta_channel_should_loop}
+    , _delta_channel_enable_interrupt{other._delta_channel_enable_interrupt}
+    , _delta_channel_sample_buffer_empty{other._delta_channel_sample_buffer_empty}
+    , _enable_dmc{other._enable_dmc}
+    , _send_delta_channel_interrupt{other._send_delta_channel_interrupt}
+{
+    std::memcpy(_channels_counters, other._channels_counters, 4);
+    std::memcpy(_channel_enabled, other._channel_enabled, 4);
+    std::memcpy(_channel_halted, other._channel_halted, 4);
+}
+
+template<class MapperType>
+void cynes::APU<MapperType>::power() {
     _latch_cycle = false;
     _delay_dma = 0x00;
     _address_dma = 0x00;
@@ -77,7 +111,8 @@ void cynes::APU::power() {
     _send_delta_channel_interrupt = false;
 }
 
-void cynes::APU::reset() {
+template<class MapperType>
+void cynes::APU<MapperType>::reset() {
     _enable_dmc = false;
 
     std::memset(_channels_counters, 0x00, 4);
@@ -99,7 +134,8 @@ void cynes::APU::reset() {
     _nes.write(0x4017, _step_mode << 7 | _inhibit_frame_interrupt << 6);
 }
 
-void cynes::APU::tick(bool reading, bool prevent_load) {
+template<class MapperType>
+void cynes::APU<MapperType>::tick(bool reading, bool prevent_load) {
     if (reading) {
         perform_pending_dma();
     }
@@ -154,7 +190,60 @@ void cynes::APU::tick(bool reading, bool prevent_load) {
     }
 }
 
-void cynes::APU::write(uint8_t address, uint8_t value) {
+template<class MapperType>
+uint32_t cynes::APU<MapperType>::get_idle_distance() const {
+    if (_pending_dma || _delay_frame_reset > 0 || _delta_channel_remaining_bytes > 0) {
+        return 0;
+    }
+
+    if (_delta_channel_period_load == 0) {
+        return 0;
+    }
+
+    if (_frame_counter_clock < 14913) {
+        return 14912 - _frame_counter_clock;
+    }
+
+    if (_step_mode) {
+        return _frame_counter_clock < 37281 ? 37280 - _frame_counter_clock : 0;
+    } else {
+        return _frame_counter_clock < 29828 ? 29827 - _frame_counter_clock : 0;
+    }
+}
+
+template<class MapperType>
+void cynes::APU<MapperType>::skip(uint32_t cycles) {
+    if (cycles & 0x1) {
+        _latch_cycle = !_latch_cycle;
+    }
+
+    _frame_counter_clock += cycles;
+
+    uint32_t distance = _delta_channel_period_counter;
+
+    if (distance == 0) {
+        distance = 0x10000;
+    }
+
+    if (cycles < distance) {
+        _delta_channel_period_counter -= cycles;
+        return;
+    }
+
+    uint32_t reloads = 1 + (cycles - distance) / _delta_channel_period_load;
+
+    _delta_channel_period_counter = _delta_channel_period_load - (cycles - distance) % _delta_channel_period_load;
+
+    if (reloads < _delta_channel_bits_in_buffer) {
+        _delta_channel_bits_in_buffer -= reloads;
+    } else {
+        _delta_channel_bits_in_buffer = 8 - (reloads - _delta_channel_bits_in_buffer) % 8;
+        _delta_channel_sample_buffer_empty = true;
+    }
+}
+
+template<class MapperType>
+void cynes::APU<MapperType>::write(uint8_t address, uint8_t value) {
     _open_bus = value;
 
     switch (static_cast<Register>(address)) {
@@ -273,7 +362,8 @@ void cynes::APU::write(uint8_t address, uint8_t value) {
     }
 }
 
-uint8_t cynes::APU::read(uint8_t address) {
+template<class MapperType>
+uint8_t cynes::APU<MapperType>::read(uint8_t address) {
     if (static_cast<Register>(address) == Register::CTRL_STATUS) {
         _open_bus = _send_delta_channel_interrupt << 7;
         _open_bus |= _send_frame_interrupt << 6;
@@ -289,7 +379,8 @@ uint8_t cynes::APU::read(uint8_t address) {
     return _open_bus;
 }
 
-void cynes::APU::update_counters() {
+template<class MapperType>
+void cynes::APU<MapperType>::update_counters() {
     for (uint8_t channel = 0; channel < 0x4; channel++) {
         if (!_channel_halted[channel] && _channels_counters[channel] > 0) {
             _channels_counters[channel]--;
@@ -297,7 +388,8 @@ void cynes::APU::update_counters() {
     }
 }
 
-void cynes::APU::load_delta_channel_byte(bool reading) {
+template<class MapperType>
+void cynes::APU<MapperType>::load_delta_channel_byte(bool reading) {
     uint8_t delay = _delay_dma;
 
     if (delay == 0) {
@@ -311,10 +403,10 @@ void cynes::APU::load_delta_channel_byte(bool reading) {
     for (uint8_t i = 0; i < delay; i++) {
         tick(false, true);
 
-        _nes.ppu.tick();
-        _nes.ppu.tick();
-        _nes.ppu.tick();
-        _nes.cpu.poll();
+        _nes.tick_ppu();
+        _nes.tick_ppu();
+        _nes.tick_ppu();
+        _nes.poll_cpu();
     }
 
     _delta_channel_sample_buffer_empty = false;
@@ -329,12 +421,14 @@ void cynes::APU::load_delta_channel_byte(bool reading) {
     }
 }
 
-void cynes::APU::perform_dma(uint8_t address) {
+template<class MapperType>
+void cynes::APU<MapperType>::perform_dma(uint8_t address) {
     _address_dma = address;
     _pending_dma = true;
 }
 
-void cynes::APU::perform_pending_dma() {
+template<class MapperType>
+void cynes::APU<MapperType>::perform_pending_dma() {
     if (!_pending_dma) {
         return;
     }
@@ -370,12 +464,25 @@ void cynes::APU::perform_pending_dma() {
     }
 }
 
-void cynes::APU::set_frame_interrupt(bool interrupt) {
+template<class MapperType>
+void cynes::APU<MapperType>::set_frame_interrupt(bool interrupt) {
     _send_frame_interrupt = interrupt;
     _nes.cpu.set_frame_interrupt(interrupt);
 }
 
-void cynes::APU::set_delta_interrupt(bool interrupt) {
+template<class MapperType>
+void cynes::APU<MapperType>::set_delta_interrupt(bool interrupt) {
     _send_delta_channel_interrupt = interrupt;
     _nes.cpu.set_delta_interrupt(interrupt);
 }
+
+
+template class cynes::APU<cynes::NROM>;
+template class cynes::APU<cynes::MMC1>;
+template class cynes::APU<cynes::UxROM>;
+template class cynes::APU<cynes::CNROM>;
+template class cynes::APU<cynes::MMC3>;
+template class cynes::APU<cynes::AxROM>;
+template class cynes::APU<cynes::MMC2>;
+template class cynes::APU<cynes::MMC4>;
+template class cynes::APU<cynes::GxROM>;
@@ -7,15 +7,21 @@
 
 namespace cynes {
 // Forward declaration.
-class NES;
+template<class MapperType> class NESCore;
 
 /// Audio Processing Unit (see https://www.nesdev.org/wiki/APU).
 /// This implementation does not produce any sound, it is only emulated for timing and
 /// interrupt purposes.
+template<class MapperType>
 class APU {
 public:
     /// Initialize the APU.
-    APU(NES& nes);
+    APU(NESCore<MapperType>& nes);
+
+    /// Initialize the APU as a copy of another APU.
+    /// @param nes Emulator owning the new APU.
+    /// @param other APU to copy the state from.
+    APU(NESCore<MapperType>& nes, const APU& other);
 
     /// Default destructor.
     ~APU() = default;
@@ -33,6 +39,16 @@ public:
     /// from `APU::load_delta_channel_byte` to avoid recursion.
     void tick(bool reading, bool prevent_load = false);
 
+    /// Get the number of reading cycles the APU can run without raising an interrupt,
+    /// clocking its counters or performing a DMA.
+    /// @return The number of cycles, zero if the next cycle may have a side effect.
+    uint32_t get_idle_distance() const;
+
+    /// Advance the APU by several reading cycles at once.
+    /// @note The number of cycles should not exceed `APU::get_idle_distance`.
+    /// @param cycles Number of cycles to skip.
+    void skip(uint32_t cycles);
+
     /// Write to the APU memory.
     /// @param address Memory address within the APU memory address space.
     /// @param value Value to write.
@@ -46,7 +62,7 @@ public:
     uint8_t read(uint8_t address);
 
 private:
-    NES& _nes;
+    NESCore<MapperType>& _nes;
 
 private:
     void update_counters();
@@ -0,0 +1,58 @@
+#include "cache.hpp"
+
+#include <cstring>
+
+
+std::mutex cynes::ROMCache::_mutex{};
+std::unordered_multimap<uint64_t, cynes::ROMCache::Entry> cynes::ROMCache::_entries{};
+
+std::shared_ptr<uint8_t[]> cynes::ROMCache::get(const uint8_t* data, size_t size) {
+    uint64_t key = hash(data, size);
+
+    std::lock_guard<std::mutex> lock{_mutex};
+
+    for (auto entry = _entries.begin(); entry != _entries.end();) {
+        if (entry->second.memory.expired()) {
+            entry = _entries.erase(entry);
+        } else {
+            entry++;
+        }
+    }
+
+    auto range = _entries.equal_range(key);
+
+    for (auto entry = range.first; entry != range.second; entry++) {
+        std::shared_ptr<uint8_t[]> memory = entry->second.memory.lock();
+
+        if (memory && entry->second.size == size && std::memcmp(memory.get(), data, size) == 0) {
+            return memory;
+        }
+    }
+
+    std::shared_ptr<uint8_t[]> memory{new uint8_t[size]};
+    std::memcpy(memory.get(), data, size);
+
+    _entries.emplace(key, Entry{memory, size});
+
+    return memory;
+}
+
+uint64_t cynes::ROMCache::hash(const uint8_t* data, size_t size) {
+    uint64_t value = 0xCBF29CE484222325;
+    size_t index = 0;
+
+    for (; index + 8 <= size; index += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + index, 8);
+
+        value ^= word;
+        value *= 0x00000100000001B3;
+    }
+
+    for (; index < size; index++) {
+        value ^= data[index];
+        value *= 0x00000100000001B3;
+    }
+
+    return value;
+}
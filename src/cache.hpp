@@ -0,0 +1,40 @@
+#ifndef __CYNES_CACHE__
+#define __CYNES_CACHE__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace cynes {
+/// Process-wide cache of read-only ROM memories.
+/// Emulators running the same game share a single copy of its PRG and CHR memories.
+/// Memories are identified by their content hash and are released once the last
+/// emulator using them is destroyed.
+class ROMCache {
+public:
+    /// Get a shared memory holding the given content.
+    /// @note The content is copied into a new memory if it is not already cached.
+    /// @param data Content of the memory.
+    /// @param size Size of the memory.
+    /// @return The shared memory.
+    static std::shared_ptr<uint8_t[]> get(const uint8_t* data, size_t size);
+
+private:
+    struct Entry {
+    public:
+        std::weak_ptr<uint8_t[]> memory;
+        size_t size;
+    };
+
+private:
+    static std::mutex _mutex;
+    static std::unordered_multimap<uint64_t, Entry> _entries;
+
+private:
+    static uint64_t hash(const uint8_t* data, size_t size);
+};
+}
+
+#endif
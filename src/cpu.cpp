@@ -3,80 +3,100 @@
 
 #include <cstring>
 
-using _addr_ptr = void (cynes::CPU::*)();;
-const _addr_ptr cynes::CPU::ADDRESSING_MODES[256] = {
-    &cynes::CPU::addr_imp, &cynes::CPU::addr_ixr, &cynes::CPU::addr_acc, &cynes::CPU::addr_ixr, &cynes::CPU::addr_zpr, &cynes::CPU::addr_zpr, &cynes::CPU::addr_zpr, &cynes::CPU::addr_zpr,
-    &cynes::CPU::addr_imp, &cynes::CPU::addr_imm, &cynes::CPU::addr_acc, &cynes::CPU::addr_imm, &cynes::CPU::addr_abr, &cynes::CPU::addr_abr, &cynes::CPU::addr_abr, &cynes::CPU::addr_abr,
-    &cynes::CPU::addr_rel, &cynes::CPU::addr_iyr, &cynes::CPU::addr_acc, &cynes::CPU::addr_iym, &cynes::CPU::addr_zxr, &cynes::CPU::addr_zxr, &cynes::CPU::addr_zxr, &cynes::CPU::addr_zxr,
-    &cynes::CPU::addr_imp, &cynes::CPU::addr_ayr, &cynes::CPU::addr_imp, &cynes::CPU::addr_aym, &cynes::CPU::addr_axr, &cynes::CPU::addr_axr, &cynes::CPU::addr_axm, &cynes::CPU::addr_axm,
-    &cynes::CPU::addr_abw, &cynes::CPU::addr_ixr, &cynes::CPU::addr_acc, &cynes::CPU::addr_ixr, &cynes::CPU::addr_zpr, &cynes::CPU::addr_zpr, &cynes::CPU::addr_zpr, &cynes::CPU::addr_zpr,
-    &cynes::CPU::addr_imp, &cynes::CPU::addr_imm, &cynes::CPU::addr_acc, &cynes::CPU::addr_imm, &cynes::CPU::addr_abr, &cynes::CPU::addr_abr, &cynes::CPU::addr_abr, &cynes::CPU::addr_abr,
-    &cynes::CPU::addr_rel, &cynes::CPU::addr_iyr, &cynes::CPU::addr_acc, &cynes::CPU::addr_iym, &cynes::CPU::addr_zxr, &cynes::CPU::addr_zxr, &cynes::CPU::addr_zxr, &cynes::CPU::addr_zxr,
-    &cynes::CPU::addr_imp, &cynes::CPU::addr_ayr, &cynes::CPU::addr_imp, &cynes::CPU::addr_aym, &cynes::CPU::addr_axr, &cynes::CPU::addr_axr, &cynes::CPU::addr_axm, &cynes::CPU::addr_axm,
-    &cynes::CPU::addr_imp, &cynes::CPU::addr_ixr, &cynes::CPU::addr_acc, &cynes::CPU::addr_ixr, &cynes::CPU::addr_zpr, &cynes::CPU::addr_zpr, &cynes::CPU::addr_zpr, &cynes::CPU::addr_zpr,
-    &cynes::CPU::addr_imp, &cynes::CPU::addr_imm, &cynes::CPU::addr_acc, &cynes::CPU::addr_imm, &cynes::CPU::addr_abw, &cynes::CPU::addr_abr, &cynes::CPU::addr_abr, &cynes::CPU::addr_abr,
-    &cynes::CPU::addr_rel, &cynes::CPU::addr_iyr, &cynes::CPU::addr_acc, &cynes::CPU::addr_iym, &cynes::CPU::addr_zxr, &cynes::CPU::addr_zxr, &cynes::CPU::addr_zxr, &cynes::CPU::addr_zxr,
-    &cynes::CPU::addr_imp, &cynes::CPU::addr_ayr, &cynes::CPU::addr_imp, &cynes::CPU::addr_aym, &cynes::CPU::addr_axr, &cynes::CPU::addr_axr, &cynes::CPU::addr_axm, &cynes::CPU::addr_axm,
-    &cynes::CPU::addr_imp, &cynes::CPU::addr_ixr, &cynes::CPU::addr_acc, &cynes::CPU::addr_ixr, &cynes::CPU::addr_zpr, &cynes::CPU::addr_zpr, &cynes::CPU::addr_zpr, &cynes::CPU::addr_zpr,
-    &cynes::CPU::addr_imp, &cynes::CPU::addr_imm, &cynes::CPU::addr_acc, &cynes::CPU::addr_imm, &cynes::CPU::addr_ind, &cynes::CPU::addr_abr, &cynes::CPU::addr_abr, &cynes::CPU::addr_abr,
-    &cynes::CPU::addr_rel, &cynes::CPU::addr_iyr, &cynes::CPU::addr_acc, &cynes::CPU::addr_iym, &cynes::CPU::addr_zxr, &cynes::CPU::addr_zxr, &cynes::CPU::addr_zxr, &cynes::CPU::addr_zxr,
-    &cynes::CPU::addr_imp, &cynes::CPU::addr_ayr, &cynes::CPU::addr_imp, &cynes::CPU::addr_aym, &cynes::CPU::addr_axr, &cynes::CPU::addr_axr, &cynes::CPU::addr_axm, &cynes::CPU::addr_axm,
-    &cynes::CPU::addr_imm, &cynes::CPU::addr_ixw, &cynes::CPU::addr_imm, &cynes::CPU::addr_ixw, &cynes::CPU::addr_zpw, &cynes::CPU::addr_zpw, &cynes::CPU::addr_zpw, &cynes::CPU::addr_zpw,
-    &cynes::CPU::addr_imp, &cynes::CPU::addr_imm, &cynes::CPU::addr_imp, &cynes::CPU::addr_imm, &cynes::CPU::addr_abw, &cynes::CPU::addr_abw, &cynes::CPU::addr_abw, &cynes::CPU::addr_abw,
-    &cynes::CPU::addr_rel, &cynes::CPU::addr_iyw, &cynes::CPU::addr_acc, &cynes::CPU::addr_iyw, &cynes::CPU::addr_zxw, &cynes::CPU::addr_zxw, &cynes::CPU::addr_zyw, &cynes::CPU::addr_zyw,
-    &cynes::CPU::addr_imp, &cynes::CPU::addr_ayw, &cynes::CPU::addr_imp, &cynes::CPU::addr_ayw, &cynes::CPU::addr_axw, &cynes::CPU::addr_axw, &cynes::CPU::addr_ayw, &cynes::CPU::addr_ayw,
-    &cynes::CPU::addr_imm, &cynes::CPU::addr_ixr, &cynes::CPU::addr_imm, &cynes::CPU::addr_ixr, &cynes::CPU::addr_zpr, &cynes::CPU::addr_zpr, &cynes::CPU::addr_zpr, &cynes::CPU::addr_zpr,
-    &cynes::CPU::addr_imp, &cynes::CPU::addr_imm, &cynes::CPU::addr_imp, &cynes::CPU::addr_imm, &cynes::CPU::addr_abr, &cynes::CPU::addr_abr, &cynes::CPU::addr_abr, &cynes::CPU::addr_abr,
-    &cynes::CPU::addr_rel, &cynes::CPU::addr_iyr, &cynes::CPU::addr_acc, &cynes::CPU::addr_iyr, &cynes::CPU::addr_zxr, &cynes::CPU::addr_zxr, &cynes::CPU::addr_zyr, &cynes::CPU::addr_zyr,
-    &cynes::CPU::addr_imp, &cynes::CPU::addr_ayr, &cynes::CPU::addr_imp, &cynes::CPU::addr_ayr, &cynes::CPU::addr_axr, &cynes::CPU::addr_axr, &cynes::CPU::addr_ayr, &cynes::CPU::addr_ayr,
-    &cynes::CPU::addr_imm, &cynes::CPU::addr_ixr, &cynes::CPU::addr_imm, &cynes::CPU::addr_ixr, &cynes::CPU::addr_zpr, &cynes::CPU::addr_zpr, &cynes::CPU::addr_zpr, &cynes::CPU::addr_zpr,
-    &cynes::CPU::addr_imp, &cynes::CPU::addr_imm, &cynes::CPU::addr_imp, &cynes::CPU::addr_imm, &cynes::CPU::addr_abr, &cynes::CPU::addr_abr, &cynes::CPU::addr_abr, &cynes::CPU::addr_abr,
-    &cynes::CPU::addr_rel, &cynes::CPU::addr_iyr, &cynes::CPU::addr_acc, &cynes::CPU::addr_iym, &cynes::CPU::addr_zxr, &cynes::CPU::addr_zxr, &cynes::CPU::addr_zxr, &cynes::CPU::addr_zxr,
-    &cynes::CPU::addr_imp, &cynes::CPU::addr_ayr, &cynes::CPU::addr_imp, &cynes::CPU::addr_aym, &cynes::CPU::addr_axr, &cynes::CPU::addr_axr, &cynes::CPU::addr_axm, &cynes::CPU::addr_axm,
-    &cynes::CPU::addr_imm, &cynes::CPU::addr_ixr, &cynes::CPU::addr_imm, &cynes::CPU::addr_ixr, &cynes::CPU::addr_zpr, &cynes::CPU::addr_zpr, &cynes::CPU::addr_zpr, &cynes::CPU::addr_zpr,
-    &cynes::CPU::addr_imp, &cynes::CPU::addr_imm, &cynes::CPU::addr_imp, &cynes::CPU::addr_imm, &cynes::CPU::addr_abr, &cynes::CPU::addr_abr, &cynes::CPU::addr_abr, &cynes::CPU::addr_abr,
-    &cynes::CPU::addr_rel, &cynes::CPU::addr_iyr, &cynes::CPU::addr_acc, &cynes::CPU::addr_iym, &cynes::CPU::addr_zxr, &cynes::CPU::addr_zxr, &cynes::CPU::addr_zxr, &cynes::CPU::addr_zxr,
-    &cynes::CPU::addr_imp, &cynes::CPU::addr_ayr, &cynes::CPU::addr_imp, &cynes::CPU::addr_aym, &cynes::CPU::addr_axr, &cynes::CPU::addr_axr, &cynes::CPU::addr_axm, &cynes::CPU::addr_axm
+constexpr uint8_t INSTRUCTION_SIZES[0x100] = {
+    1, 2, 1, 2, 2, 2, 2, 2, 1, 2, 1, 2, 3, 3, 3, 3,
+    2, 2, 1, 2, 2, 2, 2, 2, 1, 3, 1, 3, 3, 3, 3, 3,
+    3, 2, 1, 2, 2, 2, 2, 2, 1, 2, 1, 2, 3, 3, 3, 3,
+    2, 2, 1, 2, 2, 2, 2, 2, 1, 3, 1, 3, 3, 3, 3, 3,
+    1, 2, 1, 2, 2, 2, 2, 2, 1, 2, 1, 2, 3, 3, 3, 3,
+    2, 2, 1, 2, 2, 2, 2, 2, 1, 3, 1, 3, 3, 3, 3, 3,
+    1, 2, 1, 2, 2, 2, 2, 2, 1, 2, 1, 2, 3, 3, 3, 3,
+    2, 2, 1, 2, 2, 2, 2, 2, 1, 3, 1, 3, 3, 3, 3, 3,
+    2, 2, 2, 2, 2, 2, 2, 2, 1, 2, 1, 2, 3, 3, 3, 3,
+    2, 2, 1, 2, 2, 2, 2, 2, 1, 3, 1, 3, 3, 3, 3, 3,
+    2, 2, 2, 2, 2, 2, 2, 2, 1, 2, 1, 2, 3, 3, 3, 3,
+    2, 2, 1, 2, 2, 2, 2, 2, 1, 3, 1, 3, 3, 3, 3, 3,
+    2, 2, 2, 2, 2, 2, 2, 2, 1, 2, 1, 2, 3, 3, 3, 3,
+    2, 2, 1, 2, 2, 2, 2, 2, 1, 3, 1, 3, 3, 3, 3, 3,
+    2, 2, 2, 2, 2, 2, 2, 2, 1, 2, 1, 2, 3, 3, 3, 3,
+    2, 2, 1, 2, 2, 2, 2, 2, 1, 3, 1, 3, 3, 3, 3, 3
 };
 
-using _op_ptr = void (cynes::CPU::*)();;
-const _op_ptr cynes::CPU::INSTRUCTIONS[256] = {
-    &cynes::CPU::op_brk, &cynes::CPU::op_ora, &cynes::CPU::op_jam, &cynes::CPU::op_slo, &cynes::CPU::op_nop, &cynes::CPU::op_ora, &cynes:: CPU::op_asl, &cynes::CPU::op_slo,
-    &cynes::CPU::op_php, &cynes::CPU::op_ora, &cynes::CPU::op_aal, &cynes::CPU::op_anc, &cynes::CPU::op_nop, &cynes::CPU::op_ora, &cynes:: CPU::op_asl, &cynes::CPU::op_slo,
-    &cynes::CPU::op_bpl, &cynes::CPU::op_ora, &cynes::CPU::op_jam, &cynes::CPU::op_slo, &cynes::CPU::op_nop, &cynes::CPU::op_ora, &cynes:: CPU::op_asl, &cynes::CPU::op_slo,
-    &cynes::CPU::op_clc, &cynes::CPU::op_ora, &cynes::CPU::op_nop, &cynes::CPU::op_slo, &cynes::CPU::op_nop, &cynes::CPU::op_ora, &cynes:: CPU::op_asl, &cynes::CPU::op_slo,
-    &cynes::CPU::op_jsr, &cynes::CPU::op_and, &cynes::CPU::op_jam, &cynes::CPU::op_rla, &cynes::CPU::op_bit, &cynes::CPU::op_and, &cynes:: CPU::op_rol, &cynes::CPU::op_rla,
-    &cynes::CPU::op_plp, &cynes::CPU::op_and, &cynes::CPU::op_ral, &cynes::CPU::op_anc, &cynes::CPU::op_bit, &cynes::CPU::op_and, &cynes:: CPU::op_rol, &cynes::CPU::op_rla,
-    &cynes::CPU::op_bmi, &cynes::CPU::op_and, &cynes::CPU::op_jam, &cynes::CPU::op_rla, &cynes::CPU::op_nop, &cynes::CPU::op_and, &cynes:: CPU::op_rol, &cynes::CPU::op_rla,
-    &cynes::CPU::op_sec, &cynes::CPU::op_and, &cynes::CPU::op_nop, &cynes::CPU::op_rla, &cynes::CPU::op_nop, &cynes::CPU::op_and, &cynes:: CPU::op_rol, &cynes::CPU::op_rla,
-    &cynes::CPU::op_rti, &cynes::CPU::op_eor, &cynes::CPU::op_jam, &cynes::CPU::op_sre, &cynes::CPU::op_nop, &cynes::CPU::op_eor, &cynes:: CPU::op_lsr, &cynes::CPU::op_sre,
-    &cynes::CPU::op_pha, &cynes::CPU::op_eor, &cynes::CPU::op_lar, &cynes::CPU::op_alr, &cynes::CPU::op_jmp, &cynes::CPU::op_eor, &cynes:: CPU::op_lsr, &cynes::CPU::op_sre,
-    &cynes::CPU::op_bvc, &cynes::CPU::op_eor, &cynes::CPU::op_jam, &cynes::CPU::op_sre, &cynes::CPU::op_nop, &cynes::CPU::op_eor, &cynes:: CPU::op_lsr, &cynes::CPU::op_sre,
-    &cynes::CPU::op_cli, &cynes::CPU::op_eor, &cynes::CPU::op_nop, &cynes::CPU::op_sre, &cynes::CPU::op_nop, &cynes::CPU::op_eor, &cynes:: CPU::op_lsr, &cynes::CPU::op_sre,
-    &cynes::CPU::op_rts, &cynes::CPU::op_adc, &cynes::CPU::op_jam, &cynes::CPU::op_rra, &cynes::CPU::op_nop, &cynes::CPU::op_adc, &cynes:: CPU::op_ror, &cynes::CPU::op_rra,
-    &cynes::CPU::op_pla, &cynes::CPU::op_adc, &cynes::CPU::op_rar, &cynes::CPU::op_arr, &cynes::CPU::op_jmp, &cynes::CPU::op_adc, &cynes:: CPU::op_ror, &cynes::CPU::op_rra,
-    &cynes::CPU::op_bvs, &cynes::CPU::op_adc, &cynes::CPU::op_jam, &cynes::CPU::op_rra, &cynes::CPU::op_nop, &cynes::CPU::op_adc, &cynes:: CPU::op_ror, &cynes::CPU::op_rra,
-    &cynes::CPU::op_sei, &cynes::CPU::op_adc, &cynes::CPU::op_nop, &cynes::CPU::op_rra, &cynes::CPU::op_nop, &cynes::CPU::op_adc, &cynes:: CPU::op_ror, &cynes::CPU::op_rra,
-    &cynes::CPU::op_nop, &cynes::CPU::op_sta, &cynes::CPU::op_nop, &cynes::CPU::op_sax, &cynes::CPU::op_sty, &cynes::CPU::op_sta, &cynes:: CPU::op_stx, &cynes::CPU::op_sax,
-    &cynes::CPU::op_dey, &cynes::CPU::op_nop, &cynes::CPU::op_txa, &cynes::CPU::op_ane, &cynes::CPU::op_sty, &cynes::CPU::op_sta, &cynes:: CPU::op_stx, &cynes::CPU::op_sax,
-    &cynes::CPU::op_bcc, &cynes::CPU::op_sta, &cynes::CPU::op_jam, &cynes::CPU::op_sha, &cynes::CPU::op_sty, &cynes::CPU::op_sta, &cynes:: CPU::op_stx, &cynes::CPU::op_sax,
-    &cynes::CPU::op_tya, &cynes::CPU::op_sta, &cynes::CPU::op_txs, &cynes::CPU::op_tas, &cynes::CPU::op_shy, &cynes::CPU::op_sta, &cynes:: CPU::op_shx, &cynes::CPU::op_sha,
-    &cynes::CPU::op_ldy, &cynes::CPU::op_lda, &cynes::CPU::op_ldx, &cynes::CPU::op_lax, &cynes::CPU::op_ldy, &cynes::CPU::op_lda, &cynes:: CPU::op_ldx, &cynes::CPU::op_lax,
-    &cynes::CPU::op_tay, &cynes::CPU::op_lda, &cynes::CPU::op_tax, &cynes::CPU::op_lxa, &cynes::CPU::op_ldy, &cynes::CPU::op_lda, &cynes:: CPU::op_ldx, &cynes::CPU::op_lax,
-    &cynes::CPU::op_bcs, &cynes::CPU::op_lda, &cynes::CPU::op_jam, &cynes::CPU::op_lax, &cynes::CPU::op_ldy, &cynes::CPU::op_lda, &cynes:: CPU::op_ldx, &cynes::CPU::op_lax,
-    &cynes::CPU::op_clv, &cynes::CPU::op_lda, &cynes::CPU::op_tsx, &cynes::CPU::op_las, &cynes::CPU::op_ldy, &cynes::CPU::op_lda, &cynes:: CPU::op_ldx, &cynes::CPU::op_lax,
-    &cynes::CPU::op_cpy, &cynes::CPU::op_cmp, &cynes::CPU::op_nop, &cynes::CPU::op_dcp, &cynes::CPU::op_cpy, &cynes::CPU::op_cmp, &cynes:: CPU::op_dec, &cynes::CPU::op_dcp,
-    &cynes::CPU::op_iny, &cynes::CPU::op_cmp, &cynes::CPU::op_dex, &cynes::CPU::op_sbx, &cynes::CPU::op_cpy, &cynes::CPU::op_cmp, &cynes:: CPU::op_dec, &cynes::CPU::op_dcp,
-    &cynes::CPU::op_bne, &cynes::CPU::op_cmp, &cynes::CPU::op_jam, &cynes::CPU::op_dcp, &cynes::CPU::op_nop, &cynes::CPU::op_cmp, &cynes:: CPU::op_dec, &cynes::CPU::op_dcp,
-    &cynes::CPU::op_cld, &cynes::CPU::op_cmp, &cynes::CPU::op_nop, &cynes::CPU::op_dcp, &cynes::CPU::op_nop, &cynes::CPU::op_cmp, &cynes:: CPU::op_dec, &cynes::CPU::op_dcp,
-    &cynes::CPU::op_cpx, &cynes::CPU::op_sbc, &cynes::CPU::op_nop, &cynes::CPU::op_isc, &cynes::CPU::op_cpx, &cynes::CPU::op_sbc, &cynes:: CPU::op_inc, &cynes::CPU::op_isc,
-    &cynes::CPU::op_inx, &cynes::CPU::op_sbc, &cynes::CPU::op_nop, &cynes::CPU::op_usb, &cynes::CPU::op_cpx, &cynes::CPU::op_sbc, &cynes:: CPU::op_inc, &cynes::CPU::op_isc,
-    &cynes::CPU::op_beq, &cynes::CPU::op_sbc, &cynes::CPU::op_jam, &cynes::CPU::op_isc, &cynes::CPU::op_nop, &cynes::CPU::op_sbc, &cynes:: CPU::op_inc, &cynes::CPU::op_isc,
-    &cynes::CPU::op_sed, &cynes::CPU::op_sbc, &cynes::CPU::op_nop, &cynes::CPU::op_isc, &cynes::CPU::op_nop, &cynes::CPU::op_sbc, &cynes:: CPU::op_inc, &cynes::CPU::op_isc
+template<class MapperType>
+const typename cynes::CPU<MapperType>::_addr_ptr cynes::CPU<MapperType>::ADDRESSING_MODES[256] = {
+    &CPU::addr_imp, &CPU::addr_ixr, &CPU::addr_acc, &CPU::addr_ixr, &CPU::addr_zpr, &CPU::addr_zpr, &CPU::addr_zpr, &CPU::addr_zpr,
+    &CPU::addr_imp, &CPU::addr_imm, &CPU::addr_acc, &CPU::addr_imm, &CPU::addr_abr, &CPU::addr_abr, &CPU::addr_abr, &CPU::addr_abr,
+    &CPU::addr_rel, &CPU::addr_iyr, &CPU::addr_acc, &CPU::addr_iym, &CPU::addr_zxr, &CPU::addr_zxr, &CPU::addr_zxr, &CPU::addr_zxr,
+    &CPU::addr_imp, &CPU::addr_ayr, &CPU::addr_imp, &CPU::addr_aym, &CPU::addr_axr, &CPU::addr_axr, &CPU::addr_axm, &CPU::addr_axm,
+    &CPU::addr_abw, &CPU::addr_ixr, &CPU::addr_acc, &CPU::addr_ixr, &CPU::addr_zpr, &CPU::addr_zpr, &CPU::addr_zpr, &CPU::addr_zpr,
+    &CPU::addr_imp, &CPU::addr_imm, &CPU::addr_acc, &CPU::addr_imm, &CPU::addr_abr, &CPU::addr_abr, &CPU::addr_abr, &CPU::addr_abr,
+    &CPU::addr_rel, &CPU::addr_iyr, &CPU::addr_acc, &CPU::addr_iym, &CPU::addr_zxr, &CPU::addr_zxr, &CPU::addr_zxr, &CPU::addr_zxr,
+    &CPU::addr_imp, &CPU::addr_ayr, &CPU::addr_imp, &CPU::addr_aym, &CPU::addr_axr, &CPU::addr_axr, &CPU::addr_axm, &CPU::addr_axm,
+    &CPU::addr_imp, &CPU::addr_ixr, &CPU::addr_acc, &CPU::addr_ixr, &CPU::addr_zpr, &CPU::addr_zpr, &CPU::addr_zpr, &CPU::addr_zpr,
+    &CPU::addr_imp, &CPU::addr_imm, &CPU::addr_acc, &CPU::addr_imm, &CPU::addr_abw, &CPU::addr_abr, &CPU::addr_abr, &CPU::addr_abr,
+    &CPU::addr_rel, &CPU::addr_iyr, &CPU::addr_acc, &CPU::addr_iym, &CPU::addr_zxr, &CPU::addr_zxr, &CPU::addr_zxr, &CPU::addr_zxr,
+    &CPU::addr_imp, &CPU::addr_ayr, &CPU::addr_imp, &CPU::addr_aym, &CPU::addr_axr, &CPU::addr_axr, &CPU::addr_axm, &CPU::addr_axm,
+    &CPU::addr_imp, &CPU::addr_ixr, &CPU::addr_acc, &CPU::addr_ixr, &CPU::addr_zpr, &CPU::addr_zpr, &CPU::addr_zpr, &CPU::addr_zpr,
+    &CPU::addr_imp, &CPU::addr_imm, &CPU::addr_acc, &CPU::addr_imm, &CPU::addr_ind, &CPU::addr_abr, &CPU::addr_abr, &CPU::addr_abr,
+    &CPU::addr_rel, &CPU::addr_iyr, &CPU::addr_acc, &CPU::addr_iym, &CPU::addr_zxr, &CPU::addr_zxr, &CPU::addr_zxr, &CPU::addr_zxr,
+    &CPU::addr_imp, &CPU::addr_ayr, &CPU::addr_imp, &CPU::addr_aym, &CPU::addr_axr, &CPU::addr_axr, &CPU::addr_axm, &CPU::addr_axm,
+    &CPU::addr_imm, &CPU::addr_ixw, &CPU::addr_imm, &CPU::addr_ixw, &CPU::addr_zpw, &CPU::addr_zpw, &CPU::addr_zpw, &CPU::addr_zpw,
+    &CPU::addr_imp, &CPU::addr_imm, &CPU::addr_imp, &CPU::addr_imm, &CPU::addr_abw, &CPU::addr_abw, &CPU::addr_abw, &CPU::addr_abw,
+    &CPU::addr_rel, &CPU::addr_iyw, &CPU::addr_acc, &CPU::addr_iyw, &CPU::addr_zxw, &CPU::addr_zxw, &CPU::addr_zyw, &CPU::addr_zyw,
+    &CPU::addr_imp, &CPU::addr_ayw, &CPU::addr_imp, &CPU::addr_ayw, &CPU::addr_axw, &CPU::addr_axw, &CPU::addr_ayw, &CPU::addr_ayw,
+    &CPU::addr_imm, &CPU::addr_ixr, &CPU::addr_imm, &CPU::addr_ixr, &CPU::addr_zpr, &CPU::addr_zpr, &CPU::addr_zpr, &CPU::addr_zpr,
+    &CPU::addr_imp, &CPU::addr_imm, &CPU::addr_imp, &CPU::addr_imm, &CPU::addr_abr, &CPU::addr_abr, &CPU::addr_abr, &CPU::addr_abr,
+    &CPU::addr_rel, &CPU::addr_iyr, &CPU::addr_acc, &CPU::addr_iyr, &CPU::addr_zxr, &CPU::addr_zxr, &CPU::addr_zyr, &CPU::addr_zyr,
+    &CPU::addr_imp, &CPU::addr_ayr, &CPU::addr_imp, &CPU::addr_ayr, &CPU::addr_axr, &CPU::addr_axr, &CPU::addr_ayr, &CPU::addr_ayr,
+    &CPU::addr_imm, &CPU::addr_ixr, &CPU::addr_imm, &CPU::addr_ixr, &CPU::addr_zpr, &CPU::addr_zpr, &CPU::addr_zpr, &CPU::addr_zpr,
+    &CPU::addr_imp, &CPU::addr_imm, &CPU::addr_imp, &CPU::addr_imm, &CPU::addr_abr, &CPU::addr_abr, &CPU::addr_abr, &CPU::addr_abr,
+    &CPU::addr_rel, &CPU::addr_iyr, &CPU::addr_acc, &CPU::addr_iym, &CPU::addr_zxr, &CPU::addr_zxr, &CPU::addr_zxr, &CPU::addr_zxr,
+    &CPU::addr_imp, &CPU::addr_ayr, &CPU::addr_imp, &CPU::addr_aym, &CPU::addr_axr, &CPU::addr_axr, &CPU::addr_axm, &CPU::addr_axm,
+    &CPU::addr_imm, &CPU::addr_ixr, &CPU::addr_imm, &CPU::addr_ixr, &CPU::addr_zpr, &CPU::addr_zpr, &CPU::addr_zpr, &CPU::addr_zpr,
+    &CPU::addr_imp, &CPU::addr_imm, &CPU::addr_imp, &CPU::addr_imm, &CPU::addr_abr, &CPU::addr_abr, &CPU::addr_abr, &CPU::addr_abr,
+    &CPU::addr_rel, &CPU::addr_iyr, &CPU::addr_acc, &CPU::addr_iym, &CPU::addr_zxr, &CPU::addr_zxr, &CPU::addr_zxr, &CPU::addr_zxr,
+    &CPU::addr_imp, &CPU::addr_ayr, &CPU::addr_imp, &CPU::addr_aym, &CPU::addr_axr, &CPU::addr_axr, &CPU::addr_axm, &CPU::addr_axm
+};
+
+template<class MapperType>
+const typename cynes::CPU<MapperType>::_op_ptr cynes::CPU<MapperType>::INSTRUCTIONS[256] = {
+    &CPU::op_brk, &CPU::op_ora, &CPU::op_jam, &CPU::op_slo, &CPU::op_nop, &CPU::op_ora, &CPU::op_asl, &CPU::op_slo,
+    &CPU::op_php, &CPU::op_ora, &CPU::op_aal, &CPU::op_anc, &CPU::op_nop, &CPU::op_ora, &CPU::op_asl, &CPU::op_slo,
+    &CPU::op_bpl, &CPU::op_ora, &CPU::op_jam, &CPU::op_slo, &CPU::op_nop, &CPU::op_ora, &CPU::op_asl, &CPU::op_slo,
+    &CPU::op_clc, &CPU::op_ora, &CPU::op_nop, &CPU::op_slo, &CPU::op_nop, &CPU::op_ora, &CPU::op_asl, &CPU::op_slo,
+    &CPU::op_jsr, &CPU::op_and, &CPU::op_jam, &CPU::op_rla, &CPU::op_bit, &CPU::op_and, &CPU::op_rol, &CPU::op_rla,
+    &CPU::op_plp, &CPU::op_and, &CPU::op_ral, &CPU::op_anc, &CPU::op_bit, &CPU::op_and, &CPU::op_rol, &CPU::op_rla,
+    &CPU::op_bmi, &CPU::op_and, &CPU::op_jam, &CPU::op_rla, &CPU::op_nop, &CPU::op_and, &CPU::op_rol, &CPU::op_rla,
+    &CPU::op_sec, &CPU::op_and, &CPU::op_nop, &CPU::op_rla, &CPU::op_nop, &CPU::op_and, &CPU::op_rol, &CPU::op_rla,
+    &CPU::op_rti, &CPU::op_eor, &CPU::op_jam, &CPU::op_sre, &CPU::op_nop, &CPU::op_eor, &CPU::op_lsr, &CPU::op_sre,
+    &CPU::op_pha, &CPU::op_eor, &CPU::op_lar, &CPU::op_alr, &CPU::op_jmp, &CPU::op_eor, &CPU::op_lsr, &CPU::op_sre,
+    &CPU::op_bvc, &CPU::op_eor, &CPU::op_jam, &CPU::op_sre, &CPU::op_nop, &CPU::op_eor, &CPU::op_lsr, &CPU::op_sre,
+    &CPU::op_cli, &CPU::op_eor, &CPU::op_nop, &CPU::op_sre, &CPU::op_nop, &CPU::op_eor, &CPU::op_lsr, &CPU::op_sre,
+    &CPU::op_rts, &CPU::op_adc, &CPU::op_jam, &CPU::op_rra, &CPU::op_nop, &CPU::op_adc, &CPU::op_ror, &CPU::op_rra,
+    &CPU::op_pla, &CPU::op_adc, &CPU::op_rar, &CPU::op_arr, &CPU::op_jmp, &CPU::op_adc, &CPU::op_ror, &CPU::op_rra,
+    &CPU::op_bvs, &CPU::op_adc, &CPU::op_jam, &CPU::op_rra, &CPU::op_nop, &CPU::op_adc, &CPU::op_ror, &CPU::op_rra,
+    &CPU::op_sei, &CPU::op_adc, &CPU::op_nop, &CPU::op_rra, &CPU::op_nop, &CPU::op_adc, &CPU::op_ror, &CPU::op_rra,
+    &CPU::op_nop, &CPU::op_sta, &CPU::op_nop, &CPU::op_sax, &CPU::op_sty, &CPU::op_sta, &CPU::op_stx, &CPU::op_sax,
+    &CPU::op_dey, &CPU::op_nop, &CPU::op_txa, &CPU::op_ane, &CPU::op_sty, &CPU::op_sta, &CPU::op_stx, &CPU::op_sax,
+    &CPU::op_bcc, &CPU::op_sta, &CPU::op_jam, &CPU::op_sha, &CPU::op_sty, &CPU::op_sta, &CPU::op_stx, &CPU::op_sax,
+    &CPU::op_tya, &CPU::op_sta, &CPU::op_txs, &CPU::op_tas, &CPU::op_shy, &CPU::op_sta, &CPU::op_shx, &CPU::op_sha,
+    &CPU::op_ldy, &CPU::op_lda, &CPU::op_ldx, &CPU::op_lax, &CPU::op_ldy, &CPU::op_lda, &CPU::op_ldx, &CPU::op_lax,
+    &CPU::op_tay, &CPU::op_lda, &CPU::op_tax, &CPU::op_lxa, &CPU::op_ldy, &CPU::op_lda, &CPU::op_ldx, &CPU::op_lax,
+    &CPU::op_bcs, &CPU::op_lda, &CPU::op_jam, &CPU::op_lax, &CPU::op_ldy, &CPU::op_lda, &CPU::op_ldx, &CPU::op_lax,
+    &CPU::op_clv, &CPU::op_lda, &CPU::op_tsx, &CPU::op_las, &CPU::op_ldy, &CPU::op_lda, &CPU::op_ldx, &CPU::op_lax,
+    &CPU::op_cpy, &CPU::op_cmp, &CPU::op_nop, &CPU::op_dcp, &CPU::op_cpy, &CPU::op_cmp, &CPU::op_dec, &CPU::op_dcp,
+    &CPU::op_iny, &CPU::op_cmp, &CPU::op_dex, &CPU::op_sbx, &CPU::op_cpy, &CPU::op_cmp, &CPU::op_dec, &CPU::op_dcp,
+    &CPU::op_bne, &CPU::op_cmp, &CPU::op_jam, &CPU::op_dcp, &CPU::op_nop, &CPU::op_cmp, &CPU::op_dec, &CPU::op_dcp,
+    &CPU::op_cld, &CPU::op_cmp, &CPU::op_nop, &CPU::op_dcp, &CPU::op_nop, &CPU::op_cmp, &CPU::op_dec, &CPU::op_dcp,
+    &CPU::op_cpx, &CPU::op_sbc, &CPU::op_nop, &CPU::op_isc, &CPU::op_cpx, &CPU::op_sbc, &CPU::op_inc, &CPU::op_isc,
+    &CPU::op_inx, &CPU::op_sbc, &CPU::op_nop, &CPU::op_usb, &CPU::op_cpx, &CPU::op_sbc, &CPU::op_inc, &CPU::op_isc,
+    &CPU::op_beq, &CPU::op_sbc, &CPU::op_jam, &CPU::op_isc, &CPU::op_nop, &CPU::op_sbc, &CPU::op_inc, &CPU::op_isc,
+    &CPU::op_sed, &CPU::op_sbc, &CPU::op_nop, &CPU::op_isc, &CPU::op_nop, &CPU::op_sbc, &CPU::op_inc, &CPU::op_isc
 };
 
 
-cynes::CPU::CPU(NES& nes)
+template<class MapperType>
+cynes::CPU<MapperType>::CPU(NESCore<MapperType>& nes)
 : _nes{nes}
 , _frozen{false}
 , _register_a{0x00}
@@ -85,6 +105,12 @@ cynes::CPU::CPU(NES& nes)
 , _register_m{0x00}
 , _stack_pointer{0x00}
 , _program_counter{0x0000}
+, _decoded_pages{}
+, _decoded_banks{}
+, _decoded_operands{nullptr}
+, _decoded_operands_count{0x00}
+, _idle_state{}
+, _idle_cycle{0}
 , _delay_interrupt{false}
 , _should_issue_interrupt{false}
 , _line_mapper_interrupt{false}
@@ -97,7 +123,36 @@ cynes::CPU::CPU(NES& nes)
 , _status{0x00}
 , _target_address{0x0000} {}
 
-void cynes::CPU::power() {
+template<class MapperType>
+cynes::CPU<MapperType>::CPU(NESCore<MapperType>& nes, const CPU& other)
+: _nes{nes}
+, _frozen{other._frozen}
+, _register_a{other._register_a}
+, _register_x{other._register_x}
+, _register_y{other._register_y}
+, _register_m{other._register_m}
+, _stack_pointer{other._stack_pointer}
+, _program_counter{other._program_counter}
+, _decoded_pages{}
+, _decoded_banks{}
+, _decoded_operands{nullptr}
+, _decoded_operands_count{0x00}
+, _idle_state{}
+, _idle_cycle{0}
+, _delay_interrupt{other._delay_interrupt}
+, _should_issue_interrupt{other._should_issue_interrupt}
+, _line_mapper_interrupt{other._line_mapper_interrupt}
+, _line_frame_interrupt{other._line_frame_interrupt}
+, _line_delta_interrupt{other._line_delta_interrupt}
+, _line_non_maskable_interrupt{other._line_non_maskable_interrupt}
+, _edge_detector_non_maskable_interrupt{other._edge_detector_non_maskable_interrupt}
+, _delay_non_maskable_interrupt{other._delay_non_maskable_interrupt}
+, _should_issue_non_maskable_interrupt{other._should_issue_non_maskable_interrupt}
+, _status{other._status}
+, _target_address{other._target_address} {}
+
+template<class MapperType>
+void cynes::CPU<MapperType>::power() {
     _frozen = false;
     _line_non_maskable_interrupt = false;
     _line_mapper_interrupt = false;
@@ -113,7 +168,8 @@ void cynes::CPU::power() {
     _program_counter |= _nes.read_cpu(0xFFFD) << 8;
 }
 
-void cynes::CPU::reset() {
+template<class MapperType>
+void cynes::CPU<MapperType>::reset() {
     _frozen = false;
     _line_non_maskable_interrupt = false;
     _line_mapper_interrupt = false;
@@ -125,16 +181,34 @@ void cynes::CPU::reset() {
     _program_counter |= _nes.read_cpu(0xFFFD) << 8;
 }
 
-void cynes::CPU::tick() {
+template<class MapperType>
+void cynes::CPU<MapperType>::tick() {
     if (_frozen) {
         return;
     }
 
-    uint8_t instruction = fetch_next();
+    uint16_t address = _program_counter;
+    uint8_t instruction;
+
+    if (const DecodedInstruction* decoded = decode(_program_counter)) {
+        _decoded_operands = decoded->operands;
+        _decoded_operands_count = decoded->size - 1;
+
+        instruction = _nes.fetch(decoded->opcode);
+        _program_counter++;
+    } else {
+        _decoded_operands_count = 0;
+
+        instruction = fetch_next();
+    }
 
     (this->*ADDRESSING_MODES[instruction])();
     (this->*INSTRUCTIONS[instruction])();
 
+    if (_program_counter <= address) {
+        skip_idle_loop(address, instruction);
+    }
+
     if (_delay_non_maskable_interrupt || _delay_interrupt) {
         _nes.read(_program_counter);
         _nes.read(_program_counter);
@@ -155,7 +229,8 @@ void cynes::CPU::tick() {
     }
 }
 
-void cynes::CPU::poll() {
+template<class MapperType>
+void cynes::CPU<MapperType>::poll() {
     _delay_non_maskable_interrupt = _should_issue_non_maskable_interrupt;
 
     if (!_edge_detector_non_maskable_interrupt && _line_non_maskable_interrupt) {
@@ -168,31 +243,162 @@ void cynes::CPU::poll() {
     _should_issue_interrupt = (_line_mapper_interrupt || _line_frame_interrupt || _line_delta_interrupt) && !get_status(Flag::I);
 }
 
-void cynes::CPU::set_non_maskable_interrupt(bool interrupt) {
+template<class MapperType>
+void cynes::CPU<MapperType>::set_non_maskable_interrupt(bool interrupt) {
     _line_non_maskable_interrupt = interrupt;
 }
 
-void cynes::CPU::set_mapper_interrupt(bool interrupt) {
+template<class MapperType>
+void cynes::CPU<MapperType>::set_mapper_interrupt(bool interrupt) {
     _line_mapper_interrupt = interrupt;
 }
 
-void cynes::CPU::set_frame_interrupt(bool interrupt) {
+template<class MapperType>
+void cynes::CPU<MapperType>::set_frame_interrupt(bool interrupt) {
     _line_frame_interrupt = interrupt;
 }
 
-void cynes::CPU::set_delta_interrupt(bool interrupt) {
+template<class MapperType>
+void cynes::CPU<MapperType>::set_delta_interrupt(bool interrupt) {
     _line_delta_interrupt = interrupt;
 }
 
-bool cynes::CPU::is_frozen() const {
+template<class MapperType>
+bool cynes::CPU<MapperType>::is_frozen() const {
     return _frozen;
 }
 
-uint8_t cynes::CPU::fetch_next() {
+template<class MapperType>
+uint8_t cynes::CPU<MapperType>::fetch_next() {
+    if (_decoded_operands_count) {
+        _decoded_operands_count--;
+        _program_counter++;
+
+        return _nes.fetch(*_decoded_operands++);
+    }
+
     return _nes.read(_program_counter++);
 }
 
-void cynes::CPU::set_status(uint8_t flag, bool value) {
+template<class MapperType>
+const typename cynes::CPU<MapperType>::DecodedInstruction* cynes::CPU<MapperType>::decode(uint16_t address) {
+    if (address < 0x8000) {
+        return nullptr;
+    }
+
+    const uint8_t* bank = _nes.get_mapper().get_bank_prg(address);
+
+    if (bank == nullptr) {
+        return nullptr;
+    }
+
+    uint8_t page = (address >> 10) & 0x1F;
+
+    if (_decoded_banks[page] != bank) {
+        _decoded_banks[page] = bank;
+
+        if (_decoded_pages[page] == nullptr) {
+            _decoded_pages[page] = std::make_unique<DecodedInstruction[]>(0x400);
+        } else {
+            for (uint16_t k = 0x000; k < 0x400; k++) {
+                _decoded_pages[page][k].size = 0x00;
+            }
+        }
+    }
+
+    DecodedInstruction& instruction = _decoded_pages[page][address & 0x3FF];
+
+    if (instruction.size == 0x00) {
+        uint16_t offset = address & 0x3FF;
+        uint8_t size = INSTRUCTION_SIZES[bank[offset]];
+
+        if (offset + size > 0x400) {
+            return nullptr;
+        }
+
+        instruction.opcode = bank[offset];
+
+        if (size > 1) {
+            instruction.operands[0] = bank[offset + 1];
+        }
+
+        if (size > 2) {
+            instruction.operands[1] = bank[offset + 2];
+        }
+
+        instruction.size = size;
+    }
+
+    return &instruction;
+}
+
+template<class MapperType>
+bool cynes::CPU<MapperType>::IdleState::operator==(const IdleState& other) const {
+    return program_counter == other.program_counter
+        && target_address == other.target_address
+        && register_a == other.register_a
+        && register_x == other.register_x
+        && register_y == other.register_y
+        && register_m == other.register_m
+        && stack_pointer == other.stack_pointer
+        && status == other.status
+        && open_bus == other.open_bus
+        && event_cycle == other.event_cycle;
+}
+
+template<class MapperType>
+void cynes::CPU<MapperType>::skip_idle_loop(uint16_t address, uint8_t instruction) {
+    if ((instruction & 0x1F) != 0x10 && instruction != 0x4C && instruction != 0x6C) {
+        return;
+    }
+
+    IdleState state;
+
+    state.program_counter = _program_counter;
+    state.target_address = _target_address;
+    state.register_a = _register_a;
+    state.register_x = _register_x;
+    state.register_y = _register_y;
+    state.register_m = _register_m;
+    state.stack_pointer = _stack_pointer;
+    state.status = _status;
+    state.open_bus = _nes.get_open_bus();
+    state.event_cycle = _nes.get_event_cycle();
+
+    uint8_t effects = _nes.get_bus_effects();
+    uint64_t cycle = _nes.get_target_cycle();
+
+    bool idle = state == _idle_state && !(effects & _nes.SIDE_EFFECT);
+
+    idle = idle && !_delay_interrupt && !_should_issue_interrupt;
+    idle = idle && !_delay_non_maskable_interrupt && !_should_issue_non_maskable_interrupt;
+    idle = idle && _edge_detector_non_maskable_interrupt == _line_non_maskable_interrupt;
+
+    if (idle && (effects & _nes.STATUS_POLLED)) {
+        // Only `LDA/LDX/LDY/BIT $2002` followed by `BPL/BMI` are skipped, the exit
+        // condition of the loop then only depends on the vertical blank flag.
+        const DecodedInstruction* poll = decode(_program_counter);
+
+        idle = (instruction == 0x10 || instruction == 0x30) && poll != nullptr;
+        idle = idle && _program_counter + 3 == address;
+        idle = idle && (poll->opcode == 0xAD || poll->opcode == 0xAE || poll->opcode == 0xAC || poll->opcode == 0x2C);
+        idle = idle && ((poll->operands[1] << 8 | poll->operands[0]) & 0xE007) == 0x2002;
+    }
+
+    if (idle) {
+        _nes.skip_idle_loop(cycle - _idle_cycle);
+
+        cycle = _nes.get_target_cycle();
+    }
+
+    _idle_state = state;
+    _idle_cycle = cycle;
+
+    _nes.clear_bus_effects();
+}
+
+template<class MapperType>
+void cynes::CPU<MapperType>::set_status(uint8_t flag, bool value) {
     if (value) {
         _status |= flag;
     } else {
@@ -200,30 +406,36 @@ void cynes::CPU::set_status(uint8_t flag, bool value) {
     }
 }
 
-bool cynes::CPU::get_status(uint8_t flag) const {
+template<class MapperType>
+bool cynes::CPU<MapperType>::get_status(uint8_t flag) const {
     return _status & flag;
 }
 
-void cynes::CPU::addr_abr() {
+template<class MapperType>
+void cynes::CPU<MapperType>::addr_abr() {
     addr_abw();
     _register_m = _nes.read(_target_address);
 }
 
-void cynes::CPU::addr_abw() {
+template<class MapperType>
+void cynes::CPU<MapperType>::addr_abw() {
     _target_address = fetch_next();
     _target_address |= fetch_next() << 8;
 }
 
-void cynes::CPU::addr_acc() {
+template<class MapperType>
+void cynes::CPU<MapperType>::addr_acc() {
     _register_m = _nes.read(_program_counter);
 }
 
-void cynes::CPU::addr_axm() {
+template<class MapperType>
+void cynes::CPU<MapperType>::addr_axm() {
     addr_axw();
     _register_m = _nes.read(_target_address);
 }
 
-void cynes::CPU::addr_axr() {
+template<class MapperType>
+void cynes::CPU<MapperType>::addr_axr() {
     _target_address = fetch_next();
 
     uint16_t translated = _target_address + _register_x;
@@ -239,7 +451,8 @@ void cynes::CPU::addr_axr() {
     }
 }
 
-void cynes::CPU::addr_axw() {
+template<class MapperType>
+void cynes::CPU<MapperType>::addr_axw() {
     _target_address = fetch_next();
 
     uint16_t translated = _target_address + _register_x;
@@ -254,12 +467,14 @@ void cynes::CPU::addr_axw() {
     }
 }
 
-void cynes::CPU::addr_aym() {
+template<class MapperType>
+void cynes::CPU<MapperType>::addr_aym() {
     addr_ayw();
     _register_m = _nes.read(_target_address);
 }
 
-void cynes::CPU::addr_ayr() {
+template<class MapperType>
+void cynes::CPU<MapperType>::addr_ayr() {
     _target_address = fetch_next();
 
     uint16_t translated = _target_address + _register_y;
@@ -275,7 +490,8 @@ void cynes::CPU::addr_ayr() {
     }
 }
 
-void cynes::CPU::addr_ayw() {
+template<class MapperType>
+void cynes::CPU<MapperType>::addr_ayw() {
     _target_address = fetch_next();
 
     uint16_t translated = _target_address + _register_y;
@@ -290,15 +506,18 @@ void cynes::CPU::addr_ayw() {
     }
 }
 
-void cynes::CPU::addr_imm() {
+template<class MapperType>
+void cynes::CPU<MapperType>::addr_imm() {
     _register_m = fetch_next();
 }
 
-void cynes::CPU::addr_imp() {
+template<class MapperType>
+void cynes::CPU<MapperType>::addr_imp() {
     _register_m = _nes.read(_program_counter);
 }
 
-void cynes::CPU::addr_ind() {
+template<class MapperType>
+void cynes::CPU<MapperType>::addr_ind() {
     uint16_t pointer = fetch_next();
 
     pointer |= fetch_next() << 8;
@@ -312,12 +531,14 @@ void cynes::CPU::addr_ind() {
     }
 }
 
-void cynes::CPU::addr_ixr() {
+template<class MapperType>
+void cynes::CPU<MapperType>::addr_ixr() {
     addr_ixw();
     _register_m = _nes.read(_target_address);
 }
 
-void cynes::CPU::addr_ixw() {
+template<class MapperType>
+void cynes::CPU<MapperType>::addr_ixw() {
     uint8_t pointer = fetch_next();
 
     _register_m = _nes.read(pointer);
@@ -328,12 +549,14 @@ void cynes::CPU::addr_ixw() {
     _target_address |= _nes.read(++pointer & 0xFF) << 8;
 }
 
-void cynes::CPU::addr_iym() {
+template<class MapperType>
+void cynes::CPU<MapperType>::addr_iym() {
     addr_iyw();
     _register_m = _nes.read(_target_address);
 }
 
-void cynes::CPU::addr_iyr() {
+template<class MapperType>
+void cynes::CPU<MapperType>::addr_iyr() {
     uint8_t pointer = fetch_next();
 
     _target_address = _nes.read(pointer);
@@ -351,7 +574,8 @@ void cynes::CPU::addr_iyr() {
     }
 }
 
-void cynes::CPU::addr_iyw() {
+template<class MapperType>
+void cynes::CPU<MapperType>::addr_iyw() {
     uint8_t pointer = fetch_next();
 
     _target_address = _nes.read(pointer);
@@ -368,7 +592,8 @@ void cynes::CPU::addr_iyw() {
     }
 }
 
-void cynes::CPU::addr_rel() {
+template<class MapperType>
+void cynes::CPU<MapperType>::addr_rel() {
     _target_address = fetch_next();
 
     if (_target_address & 0x80) {
@@ -376,40 +601,47 @@ void cynes::CPU::addr_rel() {
     }
 }
 
-void cynes::CPU::addr_zpr() {
+template<class MapperType>
+void cynes::CPU<MapperType>::addr_zpr() {
     addr_zpw();
     _register_m = _nes.read(_target_address);
 }
 
-void cynes::CPU::addr_zpw() {
+template<class MapperType>
+void cynes::CPU<MapperType>::addr_zpw() {
     _target_address = fetch_next();
 }
 
-void cynes::CPU::addr_zxr() {
+template<class MapperType>
+void cynes::CPU<MapperType>::addr_zxr() {
     addr_zxw();
     _register_m = _nes.read(_target_address);
 }
 
-void cynes::CPU::addr_zxw() {
+template<class MapperType>
+void cynes::CPU<MapperType>::addr_zxw() {
     _target_address = fetch_next();
     _register_m = _nes.read(_target_address);
     _target_address += _register_x;
     _target_address &= 0x00FF;
 }
 
-void cynes::CPU::addr_zyr() {
+template<class MapperType>
+void cynes::CPU<MapperType>::addr_zyr() {
     addr_zyw();
     _register_m = _nes.read(_target_address);
 }
 
-void cynes::CPU::addr_zyw() {
+template<class MapperType>
+void cynes::CPU<MapperType>::addr_zyw() {
     _target_address = fetch_next();
     _register_m = _nes.read(_target_address);
     _target_address += _register_y;
     _target_address &= 0x00FF;
 }
 
-void cynes::CPU::op_aal() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_aal() {
     set_status(Flag::C, _register_a & 0x80);
 
     _register_a <<= 1;
@@ -418,7 +650,8 @@ void cynes::CPU::op_aal() {
     set_status(Flag::N, _register_a & 0x80);
 }
 
-void cynes::CPU::op_adc() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_adc() {
     uint16_t result = _register_a + _register_m + (get_status(Flag::C) ? 0x01 : 0x00);
 
     set_status(Flag::C, result & 0xFF00);
@@ -430,7 +663,8 @@ void cynes::CPU::op_adc() {
     set_status(Flag::N, _register_a & 0x80);
 }
 
-void cynes::CPU::op_alr() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_alr() {
     _register_a &= _register_m;
 
     set_status(Flag::C, _register_a & 0x01);
@@ -441,7 +675,8 @@ void cynes::CPU::op_alr() {
     set_status(Flag::N, _register_a & 0x80);
 }
 
-void cynes::CPU::op_anc() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_anc() {
     _register_a &= _register_m;
 
     set_status(Flag::Z, !_register_a);
@@ -449,18 +684,21 @@ void cynes::CPU::op_anc() {
     set_status(Flag::C, _register_a & 0x80);
 }
 
-void cynes::CPU::op_and() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_and() {
     _register_a &= _register_m;
 
     set_status(Flag::Z, !_register_a);
     set_status(Flag::N, _register_a & 0x80);
 }
 
-void cynes::CPU::op_ane() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_ane() {
     _register_a = (_register_a | 0xEE) & _register_x & _register_m;
 }
 
-void cynes::CPU::op_arr() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_arr() {
     _register_a &= _register_m;
     _register_a = (get_status(Flag::C) ? 0x80 : 0x00) | (_register_a >> 1);
 
@@ -470,7 +708,8 @@ void cynes::CPU::op_arr() {
     set_status(Flag::N, _register_a & 0x80);
 }
 
-void cynes::CPU::op_asl() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_asl() {
     _nes.write(_target_address, _register_m);
 
     set_status(Flag::C, _register_m & 0x80);
@@ -483,7 +722,8 @@ void cynes::CPU::op_asl() {
     _nes.write(_target_address, _register_m);
 }
 
-void cynes::CPU::op_bcc() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_bcc() {
     if (!get_status(Flag::C)) {
         if (_should_issue_interrupt && !_delay_interrupt) {
             _should_issue_interrupt = false;
@@ -501,7 +741,8 @@ void cynes::CPU::op_bcc() {
     }
 }
 
-void cynes::CPU::op_bcs() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_bcs() {
     if (get_status(Flag::C)) {
         if (_should_issue_interrupt && !_delay_interrupt) {
             _should_issue_interrupt = false;
@@ -519,7 +760,8 @@ void cynes::CPU::op_bcs() {
     }
 }
 
-void cynes::CPU::op_beq() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_beq() {
     if (get_status(Flag::Z)) {
         if (_should_issue_interrupt && !_delay_interrupt) {
             _should_issue_interrupt = false;
@@ -537,13 +779,15 @@ void cynes::CPU::op_beq() {
     }
 }
 
-void cynes::CPU::op_bit() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_bit() {
     set_status(Flag::Z, !(_register_a & _register_m));
     set_status(Flag::V, _register_m & 0x40);
     set_status(Flag::N, _register_m & 0x80);
 }
 
-void cynes::CPU::op_bmi() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_bmi() {
     if (get_status(Flag::N)) {
         if (_should_issue_interrupt && !_delay_interrupt) {
             _should_issue_interrupt = false;
@@ -561,7 +805,8 @@ void cynes::CPU::op_bmi() {
     }
 }
 
-void cynes::CPU::op_bne() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_bne() {
     if (!get_status(Flag::Z)) {
         if (_should_issue_interrupt && !_delay_interrupt) {
             _should_issue_interrupt = false;
@@ -579,7 +824,8 @@ void cynes::CPU::op_bne() {
     }
 }
 
-void cynes::CPU::op_bpl() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_bpl() {
     if (!get_status(Flag::N)) {
         if (_should_issue_interrupt && !_delay_interrupt) {
             _should_issue_interrupt = false;
@@ -597,7 +843,8 @@ void cynes::CPU::op_bpl() {
     }
 }
 
-void cynes::CPU::op_brk() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_brk() {
     _program_counter++;
 
     _nes.write(0x100 | _stack_pointer--, _program_counter >> 8);
@@ -617,7 +864,8 @@ void cynes::CPU::op_brk() {
     _delay_non_maskable_interrupt = false;
 }
 
-void cynes::CPU::op_bvc() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_bvc() {
     if (!get_status(Flag::V)) {
         if (_should_issue_interrupt && !_delay_interrupt) {
             _should_issue_interrupt = false;
@@ -635,7 +883,8 @@ void cynes::CPU::op_bvc() {
     }
 }
 
-void cynes::CPU::op_bvs() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_bvs() {
     if (get_status(Flag::V)) {
         if (_should_issue_interrupt && !_delay_interrupt) {
             _should_issue_interrupt = false;
@@ -653,41 +902,49 @@ void cynes::CPU::op_bvs() {
     }
 }
 
-void cynes::CPU::op_clc() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_clc() {
     set_status(Flag::C, false);
 }
 
-void cynes::CPU::op_cld() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_cld() {
     set_status(Flag::D, false);
 }
 
-void cynes::CPU::op_cli() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_cli() {
     set_status(Flag::I, false);
 }
 
-void cynes::CPU::op_clv() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_clv() {
     set_status(Flag::V, false);
 }
 
-void cynes::CPU::op_cmp() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_cmp() {
     set_status(Flag::C, _register_a >= _register_m);
     set_status(Flag::Z, _register_a == _register_m);
     set_status(Flag::N, (_register_a - _register_m) & 0x80);
 }
 
-void cynes::CPU::op_cpx() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_cpx() {
     set_status(Flag::C, _register_x >= _register_m);
     set_status(Flag::Z, _register_x == _register_m);
     set_status(Flag::N, (_register_x - _register_m) & 0x80);
 }
 
-void cynes::CPU::op_cpy() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_cpy() {
     set_status(Flag::C, _register_y >= _register_m);
     set_status(Flag::Z, _register_y == _register_m);
     set_status(Flag::N, (_register_y - _register_m) & 0x80);
 }
 
-void cynes::CPU::op_dcp() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_dcp() {
     _nes.write(_target_address, _register_m);
 
     _register_m--;
@@ -699,7 +956,8 @@ void cynes::CPU::op_dcp() {
     _nes.write(_target_address, _register_m);
 }
 
-void cynes::CPU::op_dec() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_dec() {
     _nes.write(_target_address, _register_m);
 
     _register_m--;
@@ -710,28 +968,32 @@ void cynes::CPU::op_dec() {
     _nes.write(_target_address, _register_m);
 }
 
-void cynes::CPU::op_dex() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_dex() {
     _register_x--;
 
     set_status(Flag::Z, !_register_x);
     set_status(Flag::N, _register_x & 0x80);
 }
 
-void cynes::CPU::op_dey() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_dey() {
     _register_y--;
 
     set_status(Flag::Z, !_register_y);
     set_status(Flag::N, _register_y & 0x80);
 }
 
-void cynes::CPU::op_eor() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_eor() {
     _register_a ^= _register_m;
 
     set_status(Flag::Z, !_register_a);
     set_status(Flag::N, _register_a & 0x80);
 }
 
-void cynes::CPU::op_inc() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_inc() {
     _nes.write(_target_address, _register_m);
 
     _register_m++;
@@ -742,21 +1004,24 @@ void cynes::CPU::op_inc() {
     _nes.write(_target_address, _register_m);
 }
 
-void cynes::CPU::op_inx() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_inx() {
     _register_x++;
 
     set_status(Flag::Z, !_register_x);
     set_status(Flag::N, _register_x & 0x80);
 }
 
-void cynes::CPU::op_iny() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_iny() {
     _register_y++;
 
     set_status(Flag::Z, !_register_y);
     set_status(Flag::N, _register_y & 0x80);
 }
 
-void cynes::CPU::op_isc() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_isc() {
     _nes.write(_target_address, _register_m);
 
     _register_m++;
@@ -778,15 +1043,18 @@ void cynes::CPU::op_isc() {
     _nes.write(_target_address, value);
 }
 
-void cynes::CPU::op_jam() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_jam() {
     _frozen = true;
 }
 
-void cynes::CPU::op_jmp() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_jmp() {
     _program_counter = _target_address;
 }
 
-void cynes::CPU::op_jsr() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_jsr() {
     _nes.read(_program_counter);
 
     _program_counter--;
@@ -797,7 +1065,8 @@ void cynes::CPU::op_jsr() {
     _program_counter = _target_address;
 }
 
-void cynes::CPU::op_lar() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_lar() {
     set_status(Flag::C, _register_a & 0x01);
 
     _register_a >>= 1;
@@ -806,7 +1075,8 @@ void cynes::CPU::op_lar() {
     set_status(Flag::N, _register_a & 0x80);
 }
 
-void cynes::CPU::op_las() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_las() {
     uint8_t result = _register_m & _stack_pointer;
 
     _register_a = result;
@@ -814,7 +1084,8 @@ void cynes::CPU::op_las() {
     _stack_pointer = result;
 }
 
-void cynes::CPU::op_lax() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_lax() {
     _register_a = _register_m;
     _register_x = _register_m;
 
@@ -822,28 +1093,32 @@ void cynes::CPU::op_lax() {
     set_status(Flag::N, _register_m & 0x80);
 }
 
-void cynes::CPU::op_lda() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_lda() {
     _register_a = _register_m;
 
     set_status(Flag::Z, !_register_a);
     set_status(Flag::N, _register_a & 0x80);
 }
 
-void cynes::CPU::op_ldx() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_ldx() {
     _register_x = _register_m;
 
     set_status(Flag::Z, !_register_x);
     set_status(Flag::N, _register_x & 0x80);
 }
 
-void cynes::CPU::op_ldy() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_ldy() {
     _register_y = _register_m;
 
     set_status(Flag::Z, !_register_y);
     set_status(Flag::N, _register_y & 0x80);
 }
 
-void cynes::CPU::op_lsr() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_lsr() {
     _nes.write(_target_address, _register_m);
 
     set_status(Flag::C, _register_m & 0x01);
@@ -856,7 +1131,8 @@ void cynes::CPU::op_lsr() {
     _nes.write(_target_address, _register_m);
 }
 
-void cynes::CPU::op_lxa() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_lxa() {
     _register_a = _register_m;
     _register_x = _register_m;
 
@@ -864,24 +1140,29 @@ void cynes::CPU::op_lxa() {
     set_status(Flag::N, _register_a & 0x80);
 }
 
-void cynes::CPU::op_nop() {}
+template<class MapperType>
+void cynes::CPU<MapperType>::op_nop() {}
 
-void cynes::CPU::op_ora() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_ora() {
     _register_a |= _register_m;
 
     set_status(Flag::Z, !_register_a);
     set_status(Flag::N, _register_a & 0x80);
 }
 
-void cynes::CPU::op_pha() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_pha() {
     _nes.write(0x100 | _stack_pointer--, _register_a);
 }
 
-void cynes::CPU::op_php() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_php() {
     _nes.write(0x100 | _stack_pointer--, _status | Flag::B | Flag::U);
 }
 
-void cynes::CPU::op_pla() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_pla() {
     _stack_pointer++;
     _nes.read(_program_counter);
     _register_a = _nes.read(0x100 | _stack_pointer);
@@ -890,13 +1171,15 @@ void cynes::CPU::op_pla() {
     set_status(Flag::N, _register_a & 0x80);
 }
 
-void cynes::CPU::op_plp() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_plp() {
     _stack_pointer++;
     _nes.read(_program_counter);
     _status = _nes.read(0x100 | _stack_pointer) & 0xCF;
 }
 
-void cynes::CPU::op_ral() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_ral() {
     bool carry = _register_a & 0x80;
 
     _register_a = (get_status(Flag::C) ? 0x01 : 0x00) | (_register_a << 1);
@@ -906,7 +1189,8 @@ void cynes::CPU::op_ral() {
     set_status(Flag::N, _register_a & 0x80);
 }
 
-void cynes::CPU::op_rar() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_rar() {
     bool carry = _register_a & 0x01;
 
     _register_a = (get_status(Flag::C) ? 0x80 : 0x00) | (_register_a >> 1);
@@ -916,7 +1200,8 @@ void cynes::CPU::op_rar() {
     set_status(Flag::N, _register_a & 0x80);
 }
 
-void cynes::CPU::op_rla() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_rla() {
     _nes.write(_target_address, _register_m);
 
     bool carry = _register_m & 0x80;
@@ -931,7 +1216,8 @@ void cynes::CPU::op_rla() {
     _nes.write(_target_address, _register_m);
 }
 
-void cynes::CPU::op_rol() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_rol() {
     _nes.write(_target_address, _register_m);
 
     bool carry = _register_m & 0x80;
@@ -945,7 +1231,8 @@ void cynes::CPU::op_rol() {
     _nes.write(_target_address, _register_m);
 }
 
-void cynes::CPU::op_ror() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_ror() {
     _nes.write(_target_address, _register_m);
 
     bool carry = _register_m & 0x01;
@@ -959,7 +1246,8 @@ void cynes::CPU::op_ror() {
     _nes.write(_target_address, _register_m);
 }
 
-void cynes::CPU::op_rra() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_rra() {
     _nes.write(_target_address, _register_m);
 
     uint8_t carry = _register_m & 0x01;
@@ -979,7 +1267,8 @@ void cynes::CPU::op_rra() {
     _nes.write(_target_address, _register_m);
 }
 
-void cynes::CPU::op_rti() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_rti() {
     _stack_pointer++;
     _nes.read(_program_counter);
     _status = _nes.read(0x100 | _stack_pointer) & 0xCF;
@@ -987,7 +1276,8 @@ void cynes::CPU::op_rti() {
     _program_counter |= _nes.read(0x100 | ++_stack_pointer) << 8;
 }
 
-void cynes::CPU::op_rts() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_rts() {
     _stack_pointer++;
 
     _nes.read(_program_counter);
@@ -998,11 +1288,13 @@ void cynes::CPU::op_rts() {
     _program_counter++;
 }
 
-void cynes::CPU::op_sax() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_sax() {
     _nes.write(_target_address, _register_a & _register_x);
 }
 
-void cynes::CPU::op_sbc() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_sbc() {
     _register_m ^= 0xFF;
 
     uint16_t result = _register_a + _register_m + (get_status(Flag::C) ? 0x01 : 0x00);
@@ -1016,7 +1308,8 @@ void cynes::CPU::op_sbc() {
     set_status(Flag::N, _register_a & 0x80);
 }
 
-void cynes::CPU::op_sbx() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_sbx() {
     _register_x &= _register_a;
 
     set_status(Flag::C, _register_x >= _register_m);
@@ -1027,35 +1320,42 @@ void cynes::CPU::op_sbx() {
     set_status(Flag::N, _register_x & 0x80);
 }
 
-void cynes::CPU::op_sec() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_sec() {
     set_status(Flag::C, true);
 }
 
-void cynes::CPU::op_sed() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_sed() {
     set_status(Flag::D, true);
 }
 
-void cynes::CPU::op_sei() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_sei() {
     set_status(Flag::I, true);
 }
 
-void cynes::CPU::op_sha() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_sha() {
     _nes.write(_target_address, _register_a & _register_x & (uint8_t(_target_address >> 8) + 1));
 }
 
-void cynes::CPU::op_shx() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_shx() {
     uint8_t address_high = 1 + (_target_address >> 8);
 
     _nes.write(((_register_x & address_high) << 8) | (_target_address & 0xFF), _register_x & address_high);
 }
 
-void cynes::CPU::op_shy() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_shy() {
     uint8_t address_high = 1 + (_target_address >> 8);
 
     _nes.write(((_register_y & address_high) << 8) | (_target_address & 0xFF), _register_y & address_high);
 }
 
-void cynes::CPU::op_slo() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_slo() {
     _nes.write(_target_address, _register_m);
 
     set_status(Flag::C, _register_m & 0x80);
@@ -1069,7 +1369,8 @@ void cynes::CPU::op_slo() {
     _nes.write(_target_address, _register_m);
 }
 
-void cynes::CPU::op_sre() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_sre() {
     _nes.write(_target_address, _register_m);
 
     set_status(Flag::C, _register_m & 0x01);
@@ -1083,64 +1384,75 @@ void cynes::CPU::op_sre() {
     _nes.write(_target_address, _register_m);
 }
 
-void cynes::CPU::op_sta() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_sta() {
     _nes.write(_target_address, _register_a);
 }
 
-void cynes::CPU::op_stx() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_stx() {
     _nes.write(_target_address, _register_x);
 }
 
-void cynes::CPU::op_sty() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_sty() {
     _nes.write(_target_address, _register_y);
 }
 
-void cynes::CPU::op_tas() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_tas() {
     _stack_pointer = _register_a & _register_x;
 
     _nes.write(_target_address, _stack_pointer & (uint8_t(_target_address >> 8) + 1));
 }
 
-void cynes::CPU::op_tax() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_tax() {
     _register_x = _register_a;
 
     set_status(Flag::Z, !_register_x);
     set_status(Flag::N, _register_x & 0x80);
 }
 
-void cynes::CPU::op_tay() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_tay() {
     _register_y = _register_a;
 
     set_status(Flag::Z, !_register_y);
     set_status(Flag::N, _register_y & 0x80);
 }
 
-void cynes::CPU::op_tsx() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_tsx() {
     _register_x = _stack_pointer;
 
     set_status(Flag::Z, !_register_x);
     set_status(Flag::N, _register_x & 0x80);
 }
 
-void cynes::CPU::op_txa() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_txa() {
     _register_a = _register_x;
 
     set_status(Flag::Z, !_register_a);
     set_status(Flag::N, _register_a & 0x80);
 }
 
-void cynes::CPU::op_txs() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_txs() {
     _stack_pointer = _register_x;
 }
 
-void cynes::CPU::op_tya() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_tya() {
     _register_a = _register_y;
 
     set_status(Flag::Z, !_register_a);
     set_status(Flag::N, _register_a & 0x80);
 }
 
-void cynes::CPU::op_usb() {
+template<class MapperType>
+void cynes::CPU<MapperType>::op_usb() {
     _register_m ^= 0xFF;
 
     uint16_t result = _register_a + _register_m + (get_status(Flag::C) ? 0x01 : 0x00);
@@ -1153,3 +1465,14 @@ void cynes::CPU::op_usb() {
     set_status(Flag::Z, !_register_a);
     set_status(Flag::N, _register_a & 0x80);
 }
+
+
+template class cynes::CPU<cynes::NROM>;
+template class cynes::CPU<cynes::MMC1>;
+template class cynes::CPU<cynes::UxROM>;
+template class cynes::CPU<cynes::CNROM>;
+template class cynes::CPU<cynes::MMC3>;
+template class cynes::CPU<cynes::AxROM>;
+template class cynes::CPU<cynes::MMC2>;
+template class cynes::CPU<cynes::MMC4>;
+template class cynes::CPU<cynes::GxROM>;
@@ -2,18 +2,25 @@
 #define __CYNES_CPU__
 
 #include <cstdint>
+#include <memory>
 
 #include "utils.hpp"
 
 namespace cynes {
 // Forward declaration.
-class NES;
+template<class MapperType> class NESCore;
 
 /// NES 6502 CPU implementation (see https://www.nesdev.org/wiki/CPU).
+template<class MapperType>
 class CPU {
 public:
     /// Initialize the CPU.
-    CPU(NES& nes);
+    CPU(NESCore<MapperType>& nes);
+
+    /// Initialize the CPU as a copy of another CPU.
+    /// @param nes Emulator owning the new CPU.
+    /// @param other CPU to copy the state from.
+    CPU(NESCore<MapperType>& nes, const CPU& other);
 
     /// Default destructor.
     ~CPU() = default;
@@ -51,7 +58,7 @@ public:
     bool is_frozen() const;
 
 private:
-    NES& _nes;
+    NESCore<MapperType>& _nes;
 
 private:
     bool _frozen;
@@ -66,6 +73,61 @@ private:
 
     uint8_t fetch_next();
 
+private:
+    /// Instruction pre-decoded from a PRG ROM bank.
+    struct DecodedInstruction {
+    public:
+        uint8_t size = 0x00;
+        uint8_t opcode = 0x00;
+        uint8_t operands[0x2] = {};
+    };
+
+    /// Decoded instructions of the $8000-$FFFF window, one table per 1KB page. The
+    /// tables are allocated on first use and their entries are only valid for the PRG
+    /// bank recorded in `_decoded_banks`.
+    std::unique_ptr<DecodedInstruction[]> _decoded_pages[0x20];
+    const uint8_t* _decoded_banks[0x20];
+
+    const uint8_t* _decoded_operands;
+    uint8_t _decoded_operands_count;
+
+    /// Get the pre-decoded instruction located at the given address.
+    /// @note Only instructions fully contained in a PRG ROM bank are decoded, code
+    /// running from RAM always goes through the bus.
+    /// @param address Address of the instruction.
+    /// @return The decoded instruction, or a null pointer if it cannot be cached.
+    const DecodedInstruction* decode(uint16_t address);
+
+private:
+    /// CPU state at the head of a loop. A loop is idle if the state is identical from
+    /// one iteration to the next one, if its bus accesses have no side effect and if
+    /// no PPU event was reached in between.
+    struct IdleState {
+    public:
+        uint16_t program_counter = 0x0000;
+        uint16_t target_address = 0x0000;
+
+        uint8_t register_a = 0x00;
+        uint8_t register_x = 0x00;
+        uint8_t register_y = 0x00;
+        uint8_t register_m = 0x00;
+        uint8_t stack_pointer = 0x00;
+        uint8_t status = 0x00;
+        uint8_t open_bus = 0x00;
+
+        uint64_t event_cycle = 0;
+
+        bool operator==(const IdleState& other) const;
+    };
+
+    IdleState _idle_state;
+    uint64_t _idle_cycle;
+
+    /// Fast-forward the loop ending with the given backward jump, if it is idle.
+    /// @param address Address of the jump instruction.
+    /// @param instruction Opcode of the jump instruction.
+    void skip_idle_loop(uint16_t address, uint8_t instruction);
+
 private:
     bool _delay_interrupt;
     bool _should_issue_interrupt;
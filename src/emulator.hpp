@@ -0,0 +1,180 @@
+#ifndef __CYNES_EMULATOR_INTERFACE__
+#define __CYNES_EMULATOR_INTERFACE__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "ppu.hpp"
+
+namespace cynes {
+// Forward declaration.
+class RewardFunction;
+
+/// Memory regions of the console exposed for side-effect-free access.
+enum class MemoryRegion : uint8_t {
+    /// Console RAM (2KB).
+    RAM,
+    /// Mapper CPU RAM, usually mapped at $6000-$7FFF.
+    PRG_RAM,
+    /// Mapper PPU RAM, holding the nametables followed by the CHR RAM.
+    VRAM,
+    /// Object attribute memory (256 bytes).
+    OAM,
+    /// Palette RAM (32 bytes).
+    PALETTE
+};
+
+/// Emulation core interface, implemented by `NESCore` for every supported mapper.
+/// @note Only the entry points used by `NES` and by the mappers go through this
+/// interface, the bus dispatch of a core is resolved at compile time.
+class Emulator {
+public:
+    Emulator() : _cycle{0}, _instructions{0}, _render_skip{false}, _reward_function{nullptr} { }
+
+    virtual ~Emulator() = default;
+
+public:
+    /// Create a copy of the emulator sharing the same ROM memory.
+    /// @return The copied emulator.
+    virtual std::unique_ptr<Emulator> clone() const = 0;
+
+    /// Reset the emulator (same effect as pressing the reset button).
+    virtual void reset() = 0;
+
+    /// Write to the console memory.
+    /// @param address Memory address within the console memory address space.
+    /// @param value Value to write.
+    virtual void write_cpu(uint16_t address, uint8_t value) = 0;
+
+    /// Read from the console memory.
+    /// @param address Memory address within the console memory address space.
+    /// @return The value stored at the given address.
+    virtual uint8_t read_cpu(uint16_t address) = 0;
+
+    /// Step the emulation by the given amount of frame.
+    /// @param controllers Controllers states.
+    /// @param frames Number of frame of the step.
+    /// @return True if the CPU is frozen, false otherwise.
+    virtual bool step(uint16_t controllers, unsigned int frames) = 0;
+
+    /// Get the size of the save state.
+    /// @return The size of the save state buffer.
+    virtual unsigned int size() = 0;
+
+    /// Save the state of the emulator to the buffer.
+    /// @param buffer Save state buffer.
+    virtual void save(uint8_t* buffer) = 0;
+
+    /// Load a previous emulator state from the buffer.
+    /// @param buffer Save state buffer.
+    virtual void load(uint8_t* buffer) = 0;
+
+    /// Get a pointer to the internal frame buffer.
+    virtual const uint8_t* get_frame_buffer() const = 0;
+
+    /// Get a pointer to the internal palette index buffer.
+    virtual const uint8_t* get_index_buffer() const = 0;
+
+    /// Get a pointer to the color emphasis bits of each scanline.
+    virtual const uint8_t* get_emphasis_buffer() const = 0;
+
+    /// Set the format of the pixels output by the PPU.
+    /// @param format New frame format.
+    virtual void set_frame_format(FrameFormat format) = 0;
+
+    /// Get the format of the pixels output by the PPU.
+    /// @return The current frame format.
+    virtual FrameFormat get_frame_format() const = 0;
+
+    /// Convert the palette index buffer to RGB colors, in the frame buffer.
+    virtual void convert_frame_buffer() = 0;
+
+    /// Redirect the pixels output by the PPU to an external buffer.
+    /// @param target Output buffer, or a null pointer to restore the internal buffers.
+    virtual void set_frame_target(uint8_t* target) = 0;
+
+    /// Get a pointer to one of the memory regions of the console.
+    /// @note The pointer stays valid for the whole lifetime of the emulator.
+    /// @param region Memory region.
+    /// @return A pointer to the memory, or a null pointer if the region is empty.
+    virtual const uint8_t* get_memory(MemoryRegion region) const = 0;
+
+    /// Get the size of one of the memory regions of the console.
+    /// @param region Memory region.
+    /// @return The size of the memory in bytes.
+    virtual size_t get_memory_size(MemoryRegion region) const = 0;
+
+    /// Read a range of the console memory without side effect.
+    /// @param address First memory address within the console memory address space.
+    /// @param values Output buffer.
+    /// @param size Number of bytes to read.
+    virtual void peek(uint16_t address, uint8_t* values, size_t size) const = 0;
+
+    /// Write a range of the console memory without side effect.
+    /// @param address First memory address within the console memory address space.
+    /// @param values Values to write.
+    /// @param size Number of bytes to write.
+    virtual void poke(uint16_t address, const uint8_t* values, size_t size) = 0;
+
+    /// Set the state of the mapper interrupt line.
+    /// @param interrupt Interrupt state.
+    virtual void set_mapper_interrupt(bool interrupt) = 0;
+
+    /// Get the current open bus state.
+    /// @return The open bus value.
+    inline uint8_t get_open_bus() const {
+        return _open_bus;
+    }
+
+    /// Get the global cycle counter.
+    /// @note The counter is incremented after every PPU dot, mappers compare it against
+    /// their own timestamps instead of being ticked.
+    /// @return The number of PPU dots emulated since power-up.
+    inline uint64_t get_cycle() const {
+        return _cycle;
+    }
+
+    /// Get the number of instructions executed by the CPU.
+    /// @note The counter is not part of the save states and starts at zero for every
+    /// emulator, clones included. Iterations of fast-forwarded idle loops are not
+    /// counted.
+    /// @return The number of instructions executed since the emulator was created.
+    inline uint64_t get_instruction_count() const {
+        return _instructions;
+    }
+
+    /// Enable or disable the rendering of intermediate frames.
+    /// @note When enabled, only the last frame of a multi-frame step is drawn in the
+    /// frame buffer. The other frames are still fully emulated, including the sprite
+    /// zero hit and every bus access, but their pixels are not output.
+    /// @param skip True to skip intermediate frames, false to render every frame.
+    inline void set_render_skip(bool skip) {
+        _render_skip = skip;
+    }
+
+    /// Check whether or not intermediate frames are skipped.
+    /// @return True if only the last frame of a step is rendered, false otherwise.
+    inline bool get_render_skip() const {
+        return _render_skip;
+    }
+
+    /// Set the reward function updated after every emulated frame.
+    /// @note The function is not owned by the emulator.
+    /// @param function Reward function, or a null pointer to disable it.
+    inline void set_reward_function(RewardFunction* function) {
+        _reward_function = function;
+    }
+
+protected:
+    uint8_t _open_bus;
+    uint64_t _cycle;
+    uint64_t _instructions;
+
+    bool _render_skip;
+
+    RewardFunction* _reward_function;
+};
+}
+
+#endif
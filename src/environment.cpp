@@ -0,0 +1,118 @@
+#include "environment.hpp"
+#include "nes.hpp"
+#include "observation.hpp"
+#include "reward.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+
+cynes::Environment::Environment(const EnvironmentConfig& config)
+    : _config{config}
+    , _generator{config.seed}
+    , _previous_action{0x00}
+{
+    if (config.frame_skip == 0) {
+        throw std::runtime_error("The frame skip must be positive.");
+    }
+
+    if (!(config.sticky_probability >= 0.0 && config.sticky_probability <= 1.0)) {
+        throw std::runtime_error("The sticky action probability must be between 0 and 1.");
+    }
+}
+
+bool cynes::Environment::step(
+    NES& nes,
+    uint16_t action,
+    ObservationPipeline* pipeline,
+    uint8_t* observation
+) {
+    unsigned int frames = _config.frame_skip;
+    unsigned int sticky = 0;
+
+    if (_config.sticky_probability > 0.0) {
+        while (sticky < frames && get_uniform() < _config.sticky_probability) {
+            sticky++;
+        }
+    }
+
+    RewardFunction* reward_function = nes.get_reward_function();
+
+    if (reward_function) {
+        reward_function->begin_step();
+    }
+
+    bool pool = pipeline && pipeline->get_config().max_pool && frames > 1;
+    bool frozen = run(nes, action, sticky, 0, pool ? frames - 1 : frames);
+
+    if (pool) {
+        pipeline->capture_previous(nes);
+
+        if (!frozen) {
+            frozen = run(nes, action, sticky, frames - 1, frames);
+        }
+    }
+
+    if (pipeline) {
+        pipeline->update(nes, observation);
+    }
+
+    if (sticky < frames) {
+        _previous_action = action;
+    }
+
+    return frozen;
+}
+
+bool cynes::Environment::reset(
+    NES& nes,
+    uint8_t* state,
+    ObservationPipeline* pipeline,
+    uint8_t* observation
+) {
+    if (state) {
+        nes.load(state);
+    } else {
+        nes.reset();
+    }
+
+    _previous_action = 0x00;
+
+    bool frozen = false;
+
+    if (_config.noop_max > 0) {
+        frozen = nes.step(0x00, 1 + _generator() % _config.noop_max);
+    }
+
+    if (pipeline) {
+        pipeline->clear();
+        pipeline->update(nes, observation);
+    }
+
+    return frozen;
+}
+
+double cynes::Environment::get_uniform() {
+    return (_generator() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+bool cynes::Environment::run(
+    NES& nes,
+    uint16_t action,
+    unsigned int sticky,
+    unsigned int begin,
+    unsigned int end
+) {
+    // Frames before `sticky` repeat the previous action, the others take the new one.
+    unsigned int split = std::min(std::max(sticky, begin), end);
+
+    if (begin < split && nes.step(_previous_action, split - begin)) {
+        return true;
+    }
+
+    if (split < end) {
+        return nes.step(action, end - split);
+    }
+
+    return false;
+}
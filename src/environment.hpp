@@ -0,0 +1,95 @@
+#ifndef __CYNES_ENVIRONMENT__
+#define __CYNES_ENVIRONMENT__
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+#include "nes.hpp"
+#include "observation.hpp"
+
+namespace cynes {
+/// Settings of an environment.
+struct EnvironmentConfig {
+public:
+    /// Number of frame emulated per action.
+    uint16_t frame_skip = 4;
+
+    /// Probability, at each frame, of repeating the previously executed action instead
+    /// of the new one.
+    double sticky_probability = 0.0;
+
+    /// Maximum number of no-op frames emulated after a reset, the actual number is
+    /// drawn uniformly between one and this value. Zero disables the no-op starts.
+    uint16_t noop_max = 0;
+
+    /// Seed of the random number generator.
+    uint64_t seed = 0;
+};
+
+/// Reinforcement learning environment policies applied around an emulator: action
+/// repeat, sticky actions and random no-op starts.
+/// @note Every random draw comes from a generator owned by the environment, two
+/// environments with the same seed, stepped with the same actions, behave identically.
+class Environment {
+public:
+    /// Initialize the environment.
+    /// @param config Environment settings.
+    Environment(const EnvironmentConfig& config);
+
+    /// Default destructor.
+    ~Environment() = default;
+
+public:
+    /// Execute an action for `EnvironmentConfig::frame_skip` frames.
+    /// @note Sticky actions are drawn frame by frame: until the new action is taken, each
+    /// frame repeats the previously executed action with the sticky probability. The
+    /// reward function of the emulator, if any, accumulates over the whole step.
+    /// @param nes Emulator to step.
+    /// @param action Controllers states (see `NES::step`).
+    /// @param pipeline Optional observation pipeline processing the frames of the step.
+    /// @param observation Output observation buffer, required with a pipeline.
+    /// @return True if the CPU is frozen, false otherwise.
+    bool step(
+        NES& nes,
+        uint16_t action,
+        ObservationPipeline* pipeline = nullptr,
+        uint8_t* observation = nullptr
+    );
+
+    /// Reset the emulator and emulate a random number of no-op frames.
+    /// @note Without no-op starts, the emulator is not stepped and the observation is
+    /// built from the frame buffer as it was before the reset.
+    /// @param nes Emulator to reset.
+    /// @param state Optional save state loaded instead of resetting the console.
+    /// @param pipeline Optional observation pipeline, cleared and fed with the last
+    /// frame.
+    /// @param observation Output observation buffer, required with a pipeline.
+    /// @return True if the CPU is frozen, false otherwise.
+    bool reset(
+        NES& nes,
+        uint8_t* state = nullptr,
+        ObservationPipeline* pipeline = nullptr,
+        uint8_t* observation = nullptr
+    );
+
+    /// Get the environment settings.
+    /// @return The settings.
+    inline const EnvironmentConfig& get_config() const {
+        return _config;
+    }
+
+private:
+    EnvironmentConfig _config;
+
+    std::mt19937_64 _generator;
+    uint16_t _previous_action;
+
+private:
+    double get_uniform();
+
+    bool run(NES& nes, uint16_t action, unsigned int sticky, unsigned int begin, unsigned int end);
+};
+}
+
+#endif
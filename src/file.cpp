@@ -0,0 +1,116 @@
+#include "file.hpp"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+#ifdef _WIN32
+cynes::MappedFile::MappedFile(const char* path)
+    : _data{nullptr}
+    , _size{0}
+    , _file{INVALID_HANDLE_VALUE}
+    , _mapping{nullptr}
+{
+    _file = CreateFileA(
+        path,
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr
+    );
+
+    if (_file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("The file cannot be read.");
+    }
+
+    LARGE_INTEGER size;
+
+    if (!GetFileSizeEx(_file, &size)) {
+        CloseHandle(_file);
+        throw std::runtime_error("The file cannot be read.");
+    }
+
+    _size = static_cast<size_t>(size.QuadPart);
+
+    if (_size == 0) {
+        return;
+    }
+
+    _mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if (_mapping == nullptr) {
+        CloseHandle(_file);
+        throw std::runtime_error("The file cannot be read.");
+    }
+
+    _data = static_cast<const uint8_t*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+
+    if (_data == nullptr) {
+        CloseHandle(_mapping);
+        CloseHandle(_file);
+        throw std::runtime_error("The file cannot be read.");
+    }
+}
+
+cynes::MappedFile::~MappedFile() {
+    if (_data != nullptr) {
+        UnmapViewOfFile(_data);
+    }
+
+    if (_mapping != nullptr) {
+        CloseHandle(_mapping);
+    }
+
+    CloseHandle(_file);
+}
+#else
+cynes::MappedFile::MappedFile(const char* path)
+    : _data{nullptr}
+    , _size{0}
+{
+    int file = open(path, O_RDONLY);
+
+    if (file < 0) {
+        throw std::runtime_error("The file cannot be read.");
+    }
+
+    struct stat status;
+
+    if (fstat(file, &status) != 0) {
+        close(file);
+        throw std::runtime_error("The file cannot be read.");
+    }
+
+    _size = static_cast<size_t>(status.st_size);
+
+    if (_size > 0) {
+        void* memory = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, file, 0);
+
+        if (memory == MAP_FAILED) {
+            close(file);
+            throw std::runtime_error("The file cannot be read.");
+        }
+
+        _data = static_cast<const uint8_t*>(memory);
+    }
+
+    close(file);
+}
+
+cynes::MappedFile::~MappedFile() {
+    if (_data != nullptr) {
+        munmap(const_cast<uint8_t*>(_data), _size);
+    }
+}
+#endif
@@ -0,0 +1,39 @@
+#ifndef __CYNES_FILE__
+#define __CYNES_FILE__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cynes {
+/// Read-only memory mapping of a file.
+class MappedFile {
+public:
+    /// Map a file into memory.
+    /// @param path Path to the file.
+    MappedFile(const char* path);
+
+    /// Unmap the file.
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+public:
+    /// Get a pointer to the content of the file.
+    inline const uint8_t* data() const { return _data; }
+
+    /// Get the size of the file.
+    inline size_t size() const { return _size; }
+
+private:
+    const uint8_t* _data;
+    size_t _size;
+
+#ifdef _WIN32
+    void* _file;
+    void* _mapping;
+#endif
+};
+}
+
+#endif
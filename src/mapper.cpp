@@ -1,10 +1,13 @@
 #include "mapper.hpp"
-#include "cpu.hpp"
-#include "nes.hpp"
+#include "emulator.hpp"
 
+#include <stdexcept>
+
+
+constexpr uint8_t EMPTY_BANK[0x400] = {};
 
 cynes::Mapper::Mapper(
-    NES& nes,
+    Emulator& nes,
     NESMetadata metadata,
     MirroringMode mode,
     uint8_t size_cpu_ram,
@@ -20,75 +23,75 @@ cynes::Mapper::Mapper(
   , _memory_ppu_ram{}
   , _banks_cpu{}
   , _banks_ppu{}
+  , _pages_cpu{}
+  , _pages_ppu{}
+  , _tiles{}
 {
     if (_size_cpu_ram) {
-        _memory_cpu_ram = new uint8_t[uint64_t(_size_cpu_ram) << 10];
+        _memory_cpu_ram.reset(new uint8_t[uint64_t(_size_cpu_ram) << 10]);
 
         if (metadata.trainer != nullptr) {
-            memcpy(_memory_cpu_ram, metadata.trainer, 0x200);
-
-            delete[] metadata.trainer;
+            memcpy(_memory_cpu_ram.get(), metadata.trainer.get(), 0x200);
         }
     }
 
     if (_size_ppu_ram) {
-        _memory_ppu_ram = new uint8_t[uint64_t(_size_ppu_ram) << 10];
+        _memory_ppu_ram.reset(new uint8_t[uint64_t(_size_ppu_ram) << 10]);
     }
 
-    set_mirroring_mode(mode);
-}
-
-cynes::Mapper::~Mapper() {
-    if (_size_prg) {
-        delete[] _memory_prg;
+    for (uint8_t k = 0x00; k < 0x10; k++) {
+        update_page_ppu(k);
     }
 
-    if (_sire_chr) {
-        delete[] _memory_chr;
-    }
+    set_mirroring_mode(mode);
+}
 
+cynes::Mapper::Mapper(Emulator& nes, const Mapper& other)
+  : _nes{nes}
+  , _size_prg{other._size_prg}
+  , _sire_chr{other._sire_chr}
+  , _size_cpu_ram{other._size_cpu_ram}
+  , _size_ppu_ram{other._size_ppu_ram}
+  , _memory_prg{other._memory_prg}
+  , _memory_chr{other._memory_chr}
+  , _memory_cpu_ram{}
+  , _memory_ppu_ram{}
+  , _banks_cpu{}
+  , _banks_ppu{}
+  , _pages_cpu{}
+  , _pages_ppu{}
+  , _tiles{}
+{
     if (_size_cpu_ram) {
-        delete[] _memory_cpu_ram;
+        _memory_cpu_ram.reset(new uint8_t[uint64_t(_size_cpu_ram) << 10]);
+        memcpy(_memory_cpu_ram.get(), other._memory_cpu_ram.get(), uint64_t(_size_cpu_ram) << 10);
     }
 
     if (_size_ppu_ram) {
-        delete[] _memory_ppu_ram;
-    }
-}
-
-void cynes::Mapper::tick() { }
-
-void cynes::Mapper::write_cpu(uint16_t address, uint8_t value) {
-    if (!_banks_cpu[address >> 10].read_only) {
-        _banks_cpu[address >> 10].memory[address & 0x3FF] = value;
-    }
-}
-
-void cynes::Mapper::write_ppu(uint16_t address, uint8_t value) {
-    if (!_banks_ppu[address >> 10].read_only) {
-        _banks_ppu[address >> 10].memory[address & 0x3FF] = value;
+        _memory_ppu_ram.reset(new uint8_t[uint64_t(_size_ppu_ram) << 10]);
+        memcpy(_memory_ppu_ram.get(), other._memory_ppu_ram.get(), uint64_t(_size_ppu_ram) << 10);
     }
-}
 
-uint8_t cynes::Mapper::read_cpu(uint16_t address) {
-    if (_banks_cpu[address >> 10].memory == nullptr) {
-        return _nes.get_open_bus();
+    for (uint8_t k = 0x00; k < 0x40; k++) {
+        _banks_cpu[k] = other._banks_cpu[k];
+        resolve_bank(_banks_cpu[k]);
+        update_pages_cpu(k);
     }
 
-    return _banks_cpu[address >> 10].memory[address & 0x3FF];
-}
-
-uint8_t cynes::Mapper::read_ppu(uint16_t address) {
-    if (_banks_ppu[address >> 10].memory == nullptr) {
-        return 0x00;
+    for (uint8_t k = 0x00; k < 0x10; k++) {
+        _banks_ppu[k] = other._banks_ppu[k];
+        resolve_bank(_banks_ppu[k]);
+        update_page_ppu(k);
     }
-
-    return _banks_ppu[address >> 10].memory[address & 0x3FF];
 }
 
 void cynes::Mapper::map_bank_prg(uint8_t page, uint16_t address) {
     _banks_cpu[page].memory = &_memory_prg[address << 10];
+    _banks_cpu[page].offset = address << 10;
+    _banks_cpu[page].source = MemorySource::PRG;
     _banks_cpu[page].read_only = true;
+
+    update_pages_cpu(page);
 }
 
 void cynes::Mapper::map_bank_prg(uint8_t page, uint8_t size, uint16_t address) {
@@ -99,7 +102,11 @@ void cynes::Mapper::map_bank_prg(uint8_t page, uint8_t size, uint16_t address) {
 
 void cynes::Mapper::map_bank_cpu_ram(uint8_t page, uint16_t address, bool read_only) {
     _banks_cpu[page].memory = &_memory_cpu_ram[address << 10];
+    _banks_cpu[page].offset = address << 10;
+    _banks_cpu[page].source = MemorySource::CPU_RAM;
     _banks_cpu[page].read_only = read_only;
+
+    update_pages_cpu(page);
 }
 
 void cynes::Mapper::map_bank_cpu_ram(uint8_t page, uint8_t size, uint16_t address, bool read_only) {
@@ -110,7 +117,11 @@ void cynes::Mapper::map_bank_cpu_ram(uint8_t page, uint8_t size, uint16_t addres
 
 void cynes::Mapper::map_bank_chr(uint8_t page, uint16_t address) {
     _banks_ppu[page].memory = &_memory_chr[address << 10];
+    _banks_ppu[page].offset = address << 10;
+    _banks_ppu[page].source = MemorySource::CHR;
     _banks_ppu[page].read_only = true;
+
+    update_page_ppu(page);
 }
 
 void cynes::Mapper::map_bank_chr(uint8_t page, uint8_t size, uint16_t address) {
@@ -121,7 +132,11 @@ void cynes::Mapper::map_bank_chr(uint8_t page, uint8_t size, uint16_t address) {
 
 void cynes::Mapper::map_bank_ppu_ram(uint8_t page, uint16_t address, bool read_only) {
     _banks_ppu[page].memory = &_memory_ppu_ram[address << 10];
+    _banks_ppu[page].offset = address << 10;
+    _banks_ppu[page].source = MemorySource::PPU_RAM;
     _banks_ppu[page].read_only = read_only;
+
+    update_page_ppu(page);
 }
 
 void cynes::Mapper::map_bank_ppu_ram(uint8_t page, uint8_t size, uint16_t address, bool read_only) {
@@ -131,8 +146,12 @@ void cynes::Mapper::map_bank_ppu_ram(uint8_t page, uint8_t size, uint16_t addres
 }
 
 void cynes::Mapper::unmap_bank_cpu(uint8_t page) {
-    _banks_ppu[page].memory = nullptr;
-    _banks_ppu[page].read_only = true;
+    _banks_cpu[page].memory = nullptr;
+    _banks_cpu[page].offset = 0x0000;
+    _banks_cpu[page].source = MemorySource::NONE;
+    _banks_cpu[page].read_only = true;
+
+    update_pages_cpu(page);
 }
 
 void cynes::Mapper::unmap_bank_cpu(uint8_t page, uint8_t size) {
@@ -167,20 +186,111 @@ void cynes::Mapper::set_mirroring_mode(MirroringMode mode) {
 
 void cynes::Mapper::mirror_cpu_banks(uint8_t page, uint8_t size, uint8_t mirror) {
     for (uint8_t index = 0; index < size; index++) {
-        _banks_cpu[mirror + index].memory = _banks_cpu[page + index].memory;
-        _banks_cpu[mirror + index].read_only = _banks_cpu[page + index].read_only;
+        _banks_cpu[mirror + index] = _banks_cpu[page + index];
+
+        update_pages_cpu(mirror + index);
     }
 }
 
 void cynes::Mapper::mirror_ppu_banks(uint8_t page, uint8_t size, uint8_t mirror) {
     for (uint8_t index = 0; index < size; index++) {
-        _banks_ppu[mirror + index].memory = _banks_ppu[page + index].memory;
-        _banks_ppu[mirror + index].read_only = _banks_ppu[page + index].read_only;
+        _banks_ppu[mirror + index] = _banks_ppu[page + index];
+
+        update_page_ppu(mirror + index);
+    }
+}
+
+void cynes::Mapper::map_console_ram(uint8_t* memory) {
+    for (uint8_t index = 0x00; index < 0x20; index++) {
+        _pages_cpu[index].read = memory + ((index & 0x07) << 8);
+        _pages_cpu[index].write = memory + ((index & 0x07) << 8);
     }
 }
 
+void cynes::Mapper::update_pages_cpu(uint8_t page) {
+    const MemoryBank& bank = _banks_cpu[page];
+
+    for (uint8_t k = 0; k < 4; k++) {
+        uint16_t index = (page << 2) | k;
+
+        // Registers and I/O ($2000-$40FF) always go through the bus dispatch, as well as
+        // writes to $8000-$FFFF, where the mappers decode their registers.
+        if (index < 0x41) {
+            continue;
+        }
+
+        _pages_cpu[index].read = bank.memory == nullptr ? nullptr : bank.memory + (k << 8);
+        _pages_cpu[index].write = index < 0x80 && !bank.read_only ? _pages_cpu[index].read : nullptr;
+    }
+}
+
+void cynes::Mapper::update_page_ppu(uint8_t page) {
+    const uint8_t* memory = EMPTY_BANK;
+
+    if (_banks_ppu[page].memory != nullptr) {
+        memory = _banks_ppu[page].memory;
+    }
+
+    // The decoded tiles stay valid while the page points to the same memory, writes to
+    // the memory invalidate them on their own.
+    if (_pages_ppu[page] != memory) {
+        _pages_ppu[page] = memory;
+        _tiles.invalidate_page(page);
+    }
+}
 
-cynes::NROM::NROM(NES& nes, NESMetadata metadata, MirroringMode mode)
+void cynes::Mapper::invalidate_tile(uint16_t address) {
+    for (uint8_t k = 0x0; k < 0x8; k++) {
+        if (_pages_ppu[k] == _pages_ppu[address >> 10]) {
+            _tiles.invalidate_tile(k << 10 | (address & 0x3FF));
+        }
+    }
+}
+
+void cynes::Mapper::resolve_bank(MemoryBank& bank) {
+    uint8_t* memory = nullptr;
+    uint32_t size = 0x0;
+
+    switch (bank.source) {
+    case MemorySource::PRG: {
+        memory = _memory_prg.get();
+        size = _size_prg;
+        break;
+    }
+
+    case MemorySource::CHR: {
+        memory = _memory_chr.get();
+        size = _sire_chr;
+        break;
+    }
+
+    case MemorySource::CPU_RAM: {
+        memory = _memory_cpu_ram.get();
+        size = _size_cpu_ram;
+        break;
+    }
+
+    case MemorySource::PPU_RAM: {
+        memory = _memory_ppu_ram.get();
+        size = _size_ppu_ram;
+        break;
+    }
+
+    default: {
+        bank.memory = nullptr;
+        return;
+    }
+    }
+
+    if (memory == nullptr || uint64_t(bank.offset) + 0x400 > uint64_t(size) << 10) {
+        throw std::runtime_error("The save state does not match the loaded ROM.");
+    }
+
+    bank.memory = &memory[bank.offset];
+}
+
+
+cynes::NROM::NROM(Emulator& nes, NESMetadata metadata, MirroringMode mode)
     : Mapper(nes, metadata, mode)
 {
     map_bank_chr(0x0, 0x8, 0x0);
@@ -195,13 +305,16 @@ cynes::NROM::NROM(NES& nes, NESMetadata metadata, MirroringMode mode)
     map_bank_cpu_ram(0x18, 0x8, 0x0, false);
 }
 
+cynes::NROM::NROM(Emulator& nes, const NROM& other)
+    : Mapper(nes, other) { }
+
 
 cynes::MMC1::MMC1(
-    NES& nes,
+    Emulator& nes,
     NESMetadata metadata,
     MirroringMode mode
 ) : Mapper(nes, metadata, mode)
-  , _tick{0x00}
+  , _write_cycle{0}
   , _registers{}
   , _register{0x00}
   , _counter{0x00}
@@ -212,10 +325,14 @@ cynes::MMC1::MMC1(
     update_banks();
 }
 
-void cynes::MMC1::tick() {
-    if (_tick < 6) {
-        _tick++;
-    }
+cynes::MMC1::MMC1(Emulator& nes, const MMC1& other)
+  : Mapper(nes, other)
+  , _write_cycle{other._write_cycle}
+  , _registers{}
+  , _register{other._register}
+  , _counter{other._counter}
+{
+    memcpy(_registers, other._registers, 0x4);
 }
 
 void cynes::MMC1::write_cpu(uint16_t address, uint8_t value) {
@@ -227,7 +344,9 @@ void cynes::MMC1::write_cpu(uint16_t address, uint8_t value) {
 }
 
 void cynes::MMC1::write_registers(uint8_t register_target, uint8_t value) {
-    if (_tick == 6) {
+    uint64_t cycle = _nes.get_cycle();
+
+    if (cycle - _write_cycle >= 6) {
         if (value & 0x80) {
             _registers[0x0] |= 0xC;
 
@@ -250,7 +369,7 @@ void cynes::MMC1::write_registers(uint8_t register_target, uint8_t value) {
         }
     }
 
-    _tick = 0;
+    _write_cycle = cycle;
 }
 
 void cynes::MMC1::update_banks() {
@@ -285,7 +404,7 @@ void cynes::MMC1::update_banks() {
 }
 
 
-cynes::UxROM::UxROM(NES& nes, NESMetadata metadata, MirroringMode mode)
+cynes::UxROM::UxROM(Emulator& nes, NESMetadata metadata, MirroringMode mode)
     : Mapper(nes, metadata, mode, 0x0, 0x10)
 {
     map_bank_prg(0x20, 0x10, 0x00);
@@ -294,6 +413,9 @@ cynes::UxROM::UxROM(NES& nes, NESMetadata metadata, MirroringMode mode)
     map_bank_ppu_ram(0x0, 0x8, 0x02, false);
 }
 
+cynes::UxROM::UxROM(Emulator& nes, const UxROM& other)
+    : Mapper(nes, other) { }
+
 void cynes::UxROM::write_cpu(uint16_t address, uint8_t value) {
     if (address < 0x8000) {
         cynes::Mapper::write_cpu(address, value);
@@ -303,7 +425,7 @@ void cynes::UxROM::write_cpu(uint16_t address, uint8_t value) {
 }
 
 
-cynes::CNROM::CNROM(NES& nes, NESMetadata metadata, MirroringMode mode)
+cynes::CNROM::CNROM(Emulator& nes, NESMetadata metadata, MirroringMode mode)
     : Mapper(nes, metadata, mode, 0x0)
 {
     map_bank_chr(0x0, 0x8, 0x0);
@@ -316,6 +438,9 @@ cynes::CNROM::CNROM(NES& nes, NESMetadata metadata, MirroringMode mode)
     }
 }
 
+cynes::CNROM::CNROM(Emulator& nes, const CNROM& other)
+    : Mapper(nes, other) { }
+
 void cynes::CNROM::write_cpu(uint16_t address, uint8_t value) {
     if (address < 0x8000) {
         cynes::Mapper::write_cpu(address, value);
@@ -326,11 +451,11 @@ void cynes::CNROM::write_cpu(uint16_t address, uint8_t value) {
 
 
 cynes::MMC3::MMC3(
-    NES& nes,
+    Emulator& nes,
     NESMetadata metadata,
     MirroringMode mode
 ) : Mapper(nes, metadata, mode)
-  , _tick{0x0000}
+  , _line_low_cycle{0}
   , _registers{}
   , _counter{0x0000}
   , _counter_reset_value{0x0000}
@@ -339,6 +464,7 @@ cynes::MMC3::MMC3(
   , _mode_chr{false}
   , _enable_interrupt{false}
   , _should_reload_interrupt{false}
+  , _line_low{false}
 {
     map_bank_chr(0x0, 0x8, 0x0);
     map_bank_prg(0x20, 0x10, 0x0);
@@ -348,10 +474,20 @@ cynes::MMC3::MMC3(
     memset(_registers, 0x0000, 0x20);
 }
 
-void cynes::MMC3::tick() {
-    if (_tick > 0 && _tick < 11) {
-        _tick++;
-    }
+cynes::MMC3::MMC3(Emulator& nes, const MMC3& other)
+  : Mapper(nes, other)
+  , _line_low_cycle{other._line_low_cycle}
+  , _registers{}
+  , _counter{other._counter}
+  , _counter_reset_value{other._counter_reset_value}
+  , _register_target{other._register_target}
+  , _mode_prg{other._mode_prg}
+  , _mode_chr{other._mode_chr}
+  , _enable_interrupt{other._enable_interrupt}
+  , _should_reload_interrupt{other._should_reload_interrupt}
+  , _line_low{other._line_low}
+{
+    memcpy(_registers, other._registers, 0x20);
 }
 
 void cynes::MMC3::write_cpu(uint16_t address, uint8_t value) {
@@ -417,51 +553,21 @@ void cynes::MMC3::write_cpu(uint16_t address, uint8_t value) {
             _enable_interrupt = true;
         } else {
             _enable_interrupt = false;
-            _nes.cpu.set_mapper_interrupt(false);
-        }
-    }
-}
-
-void cynes::MMC3::write_ppu(uint16_t address, uint8_t value) {
-    update_state(address & 0x1000);
-    cynes::Mapper::write_ppu(address, value);
-}
-
-uint8_t cynes::MMC3::read_ppu(uint16_t address) {
-    update_state(address & 0x1000);
-    return cynes::Mapper::read_ppu(address);
-}
-
-void cynes::MMC3::update_state(bool state) {
-    if (state) {
-        if (_tick > 10) {
-            if (_counter == 0 || _should_reload_interrupt) {
-                _counter = _counter_reset_value;
-            } else {
-                _counter--;
-            }
-
-            if (_counter == 0 && _enable_interrupt) {
-                _nes.cpu.set_mapper_interrupt(true);
-            }
-
-            _should_reload_interrupt = false;
+            _nes.set_mapper_interrupt(false);
         }
-
-        _tick = 0;
-    } else if (_tick == 0) {
-        _tick = 1;
     }
 }
 
-
-cynes::AxROM::AxROM(NES& nes, NESMetadata metadata)
+cynes::AxROM::AxROM(Emulator& nes, NESMetadata metadata, MirroringMode)
     : Mapper(nes, metadata, MirroringMode::ONE_SCREEN_LOW, 0x8, 0x10)
 {
     map_bank_ppu_ram(0x0, 0x8, 0x2, false);
     map_bank_prg(0x20, 0x20, 0x0);
 }
 
+cynes::AxROM::AxROM(Emulator& nes, const AxROM& other)
+    : Mapper(nes, other) { }
+
 void cynes::AxROM::write_cpu(uint16_t address, uint8_t value) {
     if (address < 0x8000) {
         cynes::Mapper::write_cpu(address, value);
@@ -477,13 +583,16 @@ void cynes::AxROM::write_cpu(uint16_t address, uint8_t value) {
 }
 
 
-cynes::GxROM::GxROM(NES& nes, NESMetadata metadata, MirroringMode mode)
+cynes::GxROM::GxROM(Emulator& nes, NESMetadata metadata, MirroringMode mode)
     : Mapper(nes, metadata, mode, 0x0)
 {
     map_bank_prg(0x20, 0x20, 0x0);
     map_bank_chr(0x00, 0x08, 0x0);
 }
 
+cynes::GxROM::GxROM(Emulator& nes, const GxROM& other)
+    : Mapper(nes, other) { }
+
 void cynes::GxROM::write_cpu(uint16_t address, uint8_t value) {
     if (address < 0x8000) {
         cynes::Mapper::write_cpu(address, value);
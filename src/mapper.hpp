@@ -1,31 +1,33 @@
 #ifndef __CYNES_MAPPER__
 #define __CYNES_MAPPER__
 
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <memory>
 
+#include "emulator.hpp"
+#include "tiles.hpp"
 #include "utils.hpp"
 
 namespace cynes {
-// Forward declaration.
-class NES;
-
 enum class MirroringMode : uint8_t {
     NONE, ONE_SCREEN_LOW, ONE_SCREEN_HIGH, HORIZONTAL, VERTICAL
 };
 
-// TODO: use smart pointers
 struct NESMetadata {
 public:
     uint16_t size_prg = 0x00;
     uint16_t size_chr = 0x00;
 
-    uint8_t* trainer = nullptr;
-    uint8_t* memory_prg = nullptr;
-    uint8_t* memory_chr = nullptr;
+    std::shared_ptr<uint8_t[]> trainer;
+    std::shared_ptr<uint8_t[]> memory_prg;
+    std::shared_ptr<uint8_t[]> memory_chr;
 };
 
 /// Generic NES Mapper (see https://www.nesdev.org/wiki/Mapper).
+/// @note Mappers are not polymorphic, the emulation core is specialized for each of
+/// them (see `NESCore`). Derived mappers hide the base functions they redefine.
 class Mapper {
 public:
     /// Initialize the mapper.
@@ -35,62 +37,242 @@ public:
     /// @param size_cpu_ram Size of the CPU RAM.
     /// @param size_ppu_ram Size of the PPU RAM.
     Mapper(
-        NES& nes,
+        Emulator& nes,
         NESMetadata metadata,
         MirroringMode mode,
         uint8_t size_cpu_ram = 0x8,
         uint8_t size_ppu_ram = 0x2
     );
 
-    virtual ~Mapper();
+    ~Mapper() = default;
 
 public:
-    /// Tick the mapper.
-    virtual void tick();
+    /// Whether or not the PPU must run in lockstep with the CPU. Mappers observing the
+    /// PPU address bus to raise interrupts cannot wait for the PPU to catch up lazily.
+    static constexpr bool LOCKSTEP = false;
+
+    /// Whether or not the mapper observes the A12 line of the PPU address bus. The PPU
+    /// only notifies the mapper through `on_ppu_a12` when the line changes.
+    static constexpr bool WATCH_PPU_A12 = false;
+
+    /// Whether or not the mapper observes the fetches of the latch trigger tiles ($0FD8,
+    /// $0FE8, $1FD8-$1FDF and $1FE8-$1FEF). The PPU only notifies the mapper through
+    /// `on_ppu_latch` when one of these addresses may have been accessed.
+    static constexpr bool WATCH_PPU_LATCHES = false;
 
     /// Write to a CPU mapped memory bank.
     /// @note This function has other side effects than simply writing to the memory, it
     /// should not be used as a memory set function.
     /// @param address Memory address within the console memory address space.
     /// @param value Value to write.
-    virtual void write_cpu(uint16_t address, uint8_t value);
+    inline void write_cpu(uint16_t address, uint8_t value) {
+        if (!_banks_cpu[address >> 10].read_only) {
+            _banks_cpu[address >> 10].memory[address & 0x3FF] = value;
+        }
+    }
 
     /// Write to a PPU mapped memory bank.
     /// @note This function has other side effects than simply writing to the memory, it
     /// should not be used as a memory set function.
     /// @param address Memory address within the console memory address space.
     /// @param value Value to write.
-    virtual void write_ppu(uint16_t address, uint8_t value);
+    inline void write_ppu(uint16_t address, uint8_t value) {
+        if (!_banks_ppu[address >> 10].read_only) {
+            _banks_ppu[address >> 10].memory[address & 0x3FF] = value;
+
+            invalidate_tile(address);
+        }
+    }
 
     /// Read from the CPU memory mapped banks.
     /// @note This function has other side effects than simply reading from memory, it
     /// should not be used as a memory watch function.
     /// @param address Memory address within the console memory address space.
     /// @return The value stored at the given address.
-    virtual uint8_t read_cpu(uint16_t address);
+    inline uint8_t read_cpu(uint16_t address) {
+        if (_banks_cpu[address >> 10].memory == nullptr) {
+            return _nes.get_open_bus();
+        }
+
+        return _banks_cpu[address >> 10].memory[address & 0x3FF];
+    }
 
     /// Read from the PPU memory mapped banks.
     /// @note This function has other side effects than simply reading from memory, it
     /// should not be used as a memory watch function.
     /// @param address Memory address within the console memory address space.
     /// @return The value stored at the given address.
-    virtual uint8_t read_ppu(uint16_t address);
+    inline uint8_t read_ppu(uint16_t address) {
+        return _pages_ppu[address >> 10][address & 0x3FF];
+    }
+
+    /// Notify the mapper of a change of the A12 line of the PPU address bus.
+    /// @param state New state of the line.
+    inline void on_ppu_a12(bool) { }
+
+    /// Notify the mapper of an access to the PPU address bus near a latch trigger tile.
+    /// @note The address is only pre-filtered, the mapper is responsible for checking
+    /// the exact trigger ranges.
+    /// @param address Memory address within the PPU address space.
+    inline void on_ppu_latch(uint16_t) { }
+
+    /// Read from the CPU memory mapped banks without side effect.
+    /// @param address Memory address within the console memory address space.
+    /// @return The value stored at the given address, or the open bus value if the
+    /// address is not mapped.
+    inline uint8_t peek_cpu(uint16_t address) const {
+        if (_banks_cpu[address >> 10].memory == nullptr) {
+            return _nes.get_open_bus();
+        }
+
+        return _banks_cpu[address >> 10].memory[address & 0x3FF];
+    }
+
+    /// Write to the CPU RAM mapped at the given address without side effect.
+    /// @note The write protection of the RAM is ignored. Addresses mapped to ROM are left
+    /// untouched, as the ROM memory is shared between emulators.
+    /// @param address Memory address within the console memory address space.
+    /// @param value Value to write.
+    inline void poke_cpu(uint16_t address, uint8_t value) {
+        if (_banks_cpu[address >> 10].source == MemorySource::CPU_RAM) {
+            _banks_cpu[address >> 10].memory[address & 0x3FF] = value;
+        }
+    }
+
+    /// Get a pointer to the mapper CPU RAM (PRG RAM).
+    /// @return A pointer to the memory, or a null pointer if the mapper has none.
+    inline uint8_t* get_cpu_ram() const {
+        return _memory_cpu_ram.get();
+    }
+
+    /// Get the size of the mapper CPU RAM.
+    /// @return The size of the memory in bytes.
+    inline size_t get_cpu_ram_size() const {
+        return static_cast<size_t>(_size_cpu_ram) << 10;
+    }
+
+    /// Get a pointer to the mapper PPU RAM (nametables, followed by the CHR RAM).
+    /// @return A pointer to the memory, or a null pointer if the mapper has none.
+    inline uint8_t* get_ppu_ram() const {
+        return _memory_ppu_ram.get();
+    }
+
+    /// Get the size of the mapper PPU RAM.
+    /// @return The size of the memory in bytes.
+    inline size_t get_ppu_ram_size() const {
+        return static_cast<size_t>(_size_ppu_ram) << 10;
+    }
+
+    /// Get the memory backing a 256 bytes page of the CPU address space, for reads.
+    /// @param address Memory address within the console memory address space.
+    /// @return A pointer to the start of the page, or a null pointer if reading the page
+    /// must go through the bus dispatch (memory mapped registers, unmapped memory).
+    inline const uint8_t* get_page_read(uint16_t address) const {
+        return _pages_cpu[address >> 8].read;
+    }
+
+    /// Get the memory backing a 256 bytes page of the CPU address space, for writes.
+    /// @param address Memory address within the console memory address space.
+    /// @return A pointer to the start of the page, or a null pointer if writing the page
+    /// must go through the bus dispatch (memory mapped registers, ROM, write-protected
+    /// memory).
+    inline uint8_t* get_page_write(uint16_t address) const {
+        return _pages_cpu[address >> 8].write;
+    }
+
+    /// Get the memory backing a 1KB page of the PPU address space.
+    /// @note Unmapped pages point to a bank filled with zeros, the returned pointer is
+    /// never null.
+    /// @param address Memory address within the PPU address space ($0000-$3EFF).
+    /// @return A pointer to the start of the page.
+    inline const uint8_t* get_page_ppu(uint16_t address) const {
+        return _pages_ppu[address >> 10];
+    }
+
+    /// Read a pattern row, whose low plane was fetched earlier by the PPU.
+    /// @note The row is taken from the tile cache, unless the low plane changed since it
+    /// was fetched, in which case it is rebuilt from the given low plane and the current
+    /// high plane. Rows at $2000 and above, which a fine Y past 7 in v can address, are
+    /// outside of the pattern tables and are never cached.
+    /// @param address Memory address of the high plane of the row.
+    /// @param row Row holding the low plane fetched earlier, in its even bits.
+    /// @param flip True to read the horizontally mirrored row.
+    /// @return The row, 2 bits per pixel.
+    inline uint16_t read_tile_row(uint16_t address, uint16_t row, bool flip) {
+        const uint8_t* page = _pages_ppu[address >> 10];
+
+        if (address < 0x2000) {
+            uint16_t value = _tiles.get_row(page, address, flip);
+
+            if ((value & 0x5555) == (row & 0x5555)) {
+                return value;
+            }
+        }
+
+        uint8_t msb_plane = page[address & 0x3FF];
+
+        if (flip) {
+            msb_plane = TileCache::mirror(msb_plane);
+        }
+
+        return (row & 0x5555) | TileCache::spread(msb_plane) << 1;
+    }
+
+    /// Map the console RAM and its mirrors ($0000-$1FFF) in the CPU page table.
+    /// @param memory Console RAM (2KB).
+    void map_console_ram(uint8_t* memory);
+
+    /// Get the PRG ROM bank mapped at the given CPU address.
+    /// @param address Memory address within the console memory address space.
+    /// @return A pointer to the start of the 1KB bank, or a null pointer if the address
+    /// is not mapped to PRG ROM.
+    inline const uint8_t* get_bank_prg(uint16_t address) const {
+        if (_banks_cpu[address >> 10].source != MemorySource::PRG) {
+            return nullptr;
+        }
+
+        return _banks_cpu[address >> 10].memory;
+    }
 
 protected:
+    enum class MemorySource : uint8_t {
+        NONE, PRG, CHR, CPU_RAM, PPU_RAM
+    };
+
+    /// 1KB memory bank. The bank is saved as a source and an offset within that source,
+    /// the host pointer is only a cache resolved when the bank is mapped or loaded.
     struct MemoryBank {
     public:
         uint8_t* memory = nullptr;
+        uint32_t offset = 0x0000;
+        MemorySource source = MemorySource::NONE;
         bool read_only = true;
 
         template<DumpOperation operation, typename T>
         constexpr void dump(T& buffer) {
-            cynes::dump<operation>(buffer, memory);
+            cynes::dump<operation>(buffer, offset);
+            cynes::dump<operation>(buffer, source);
             cynes::dump<operation>(buffer, read_only);
         }
     };
 
+    /// 256 bytes page of the CPU address space, pointing directly to its backing memory
+    /// when it can be accessed without going through the bus dispatch. The pages are
+    /// derived from the banks, and updated whenever a CPU bank is mapped.
+    struct MemoryPage {
+    public:
+        uint8_t* read = nullptr;
+        uint8_t* write = nullptr;
+    };
+
+protected:
+    /// Initialize the mapper as a copy of another mapper.
+    /// @param nes Emulator owning the new mapper.
+    /// @param other Mapper to copy the state from.
+    Mapper(Emulator& nes, const Mapper& other);
+
 protected:
-    NES& _nes;
+    Emulator& _nes;
 
 protected:
     const uint16_t _size_prg;
@@ -99,15 +281,20 @@ protected:
     const uint8_t _size_cpu_ram;
     const uint8_t _size_ppu_ram;
 
-    uint8_t* _memory_prg;
-    uint8_t* _memory_chr;
+    std::shared_ptr<uint8_t[]> _memory_prg;
+    std::shared_ptr<uint8_t[]> _memory_chr;
 
-    uint8_t* _memory_cpu_ram;
-    uint8_t* _memory_ppu_ram;
+    std::unique_ptr<uint8_t[]> _memory_cpu_ram;
+    std::unique_ptr<uint8_t[]> _memory_ppu_ram;
 
     MemoryBank _banks_cpu[0x40];
     MemoryBank _banks_ppu[0x10];
 
+    MemoryPage _pages_cpu[0x100];
+    const uint8_t* _pages_ppu[0x10];
+
+    TileCache _tiles;
+
 protected:
     void map_bank_prg(uint8_t page, uint16_t address);
     void map_bank_prg(uint8_t page, uint8_t size, uint16_t address);
@@ -129,59 +316,99 @@ protected:
     void mirror_cpu_banks(uint8_t page, uint8_t size, uint8_t mirror);
     void mirror_ppu_banks(uint8_t page, uint8_t size, uint8_t mirror);
 
+    void resolve_bank(MemoryBank& bank);
+
+    void update_pages_cpu(uint8_t page);
+    void update_page_ppu(uint8_t page);
+
+    void invalidate_tile(uint16_t address);
+
 public:
     template<DumpOperation operation, typename T>
     constexpr void dump(T& buffer) {
-        for (uint8_t k = 0x00; k < 0x40; k++) {
-            _banks_cpu[k].dump<operation>(buffer);
-        }
+        if constexpr (operation == DumpOperation::LOAD) {
+            // The banks are resolved before being mapped, a state that does not match
+            // the ROM is rejected without altering the mapper.
+            MemoryBank banks_cpu[0x40];
+            MemoryBank banks_ppu[0x10];
+
+            for (uint8_t k = 0x00; k < 0x40; k++) {
+                banks_cpu[k].dump<operation>(buffer);
+                resolve_bank(banks_cpu[k]);
+            }
 
-        for (uint8_t k = 0x00; k < 0x10; k++) {
-            _banks_ppu[k].dump<operation>(buffer);
+            for (uint8_t k = 0x00; k < 0x10; k++) {
+                banks_ppu[k].dump<operation>(buffer);
+                resolve_bank(banks_ppu[k]);
+            }
+
+            for (uint8_t k = 0x00; k < 0x40; k++) {
+                _banks_cpu[k] = banks_cpu[k];
+                update_pages_cpu(k);
+            }
+
+            for (uint8_t k = 0x00; k < 0x10; k++) {
+                _banks_ppu[k] = banks_ppu[k];
+                update_page_ppu(k);
+            }
+        } else {
+            for (uint8_t k = 0x00; k < 0x40; k++) {
+                _banks_cpu[k].dump<operation>(buffer);
+            }
+
+            for (uint8_t k = 0x00; k < 0x10; k++) {
+                _banks_ppu[k].dump<operation>(buffer);
+            }
         }
 
         if (_size_cpu_ram) {
-            cynes::dump<operation>(buffer, _memory_cpu_ram, _size_cpu_ram << 10);
+            cynes::dump<operation>(buffer, _memory_cpu_ram.get(), _size_cpu_ram << 10);
         }
 
         if (_size_ppu_ram) {
-            cynes::dump<operation>(buffer, _memory_ppu_ram, _size_ppu_ram << 10);
+            cynes::dump<operation>(buffer, _memory_ppu_ram.get(), _size_ppu_ram << 10);
+
+            // Pages still pointing to the reloaded memory were not remapped.
+            if constexpr (operation == DumpOperation::LOAD) {
+                for (uint8_t k = 0x0; k < 0x8; k++) {
+                    _tiles.invalidate_page(k);
+                }
+            }
         }
     }
 };
 
 
 /// NROM mapper (see https://www.nesdev.org/wiki/NROM).
-class NROM : public Mapper {
+class NROM final : public Mapper {
 public:
-    NROM(NES& nes, NESMetadata metadata, MirroringMode mode);
+    NROM(Emulator& nes, NESMetadata metadata, MirroringMode mode);
+    NROM(Emulator& nes, const NROM& other);
     ~NROM() = default;
 };
 
 
 /// MMC1 mapper (see https://www.nesdev.org/wiki/MMC1).
-class MMC1 : public Mapper {
+class MMC1 final : public Mapper {
 public:
-    MMC1(NES& nes, NESMetadata metadata, MirroringMode mode);
+    MMC1(Emulator& nes, NESMetadata metadata, MirroringMode mode);
+    MMC1(Emulator& nes, const MMC1& other);
     ~MMC1() = default;
 
 public:
-    /// Tick the mapper.
-    virtual void tick();
-
     /// Write to a CPU mapped memory bank.
     /// @note This function has other side effects than simply writing to the memory, it
     /// should not be used as a memory set function.
     /// @param address Memory address within the console memory address space.
     /// @param value Value to write.
-    virtual void write_cpu(uint16_t address, uint8_t value);
+    void write_cpu(uint16_t address, uint8_t value);
 
 private:
     void write_registers(uint8_t register_target, uint8_t value);
     void update_banks();
 
 private:
-    uint8_t _tick;
+    uint64_t _write_cycle;
     uint8_t _registers[0x4];
     uint8_t _register;
     uint8_t _counter;
@@ -191,7 +418,7 @@ public:
     constexpr void dump(T& buffer) {
         Mapper::dump<operation>(buffer);
 
-        cynes::dump<operation>(buffer, _tick);
+        cynes::dump<operation>(buffer, _write_cycle);
         cynes::dump<operation>(buffer, _registers);
         cynes::dump<operation>(buffer, _register);
         cynes::dump<operation>(buffer, _counter);
@@ -200,9 +427,10 @@ public:
 
 
 /// UxROM mapper (see https://www.nesdev.org/wiki/UxROM).
-class UxROM : public Mapper {
+class UxROM final : public Mapper {
 public:
-    UxROM(NES& nes, NESMetadata metadata, MirroringMode mode);
+    UxROM(Emulator& nes, NESMetadata metadata, MirroringMode mode);
+    UxROM(Emulator& nes, const UxROM& other);
     ~UxROM() = default;
 
 public:
@@ -211,14 +439,15 @@ public:
     /// should not be used as a memory set function.
     /// @param address Memory address within the console memory address space.
     /// @param value Value to write.
-    virtual void write_cpu(uint16_t address, uint8_t value);
+    void write_cpu(uint16_t address, uint8_t value);
 };
 
 
 /// CNROM mapper (see https://www.nesdev.org/wiki/CNROM).
-class CNROM : public Mapper {
+class CNROM final : public Mapper {
 public:
-    CNROM(NES& nes, NESMetadata metadata, MirroringMode mode);
+    CNROM(Emulator& nes, NESMetadata metadata, MirroringMode mode);
+    CNROM(Emulator& nes, const CNROM& other);
     ~CNROM() = default;
 
 public:
@@ -227,46 +456,57 @@ public:
     /// should not be used as a memory set function.
     /// @param address Memory address within the console memory address space.
     /// @param value Value to write.
-    virtual void write_cpu(uint16_t address, uint8_t value);
+    void write_cpu(uint16_t address, uint8_t value);
 };
 
 
 /// MMC3 mapper (see https://www.nesdev.org/wiki/MMC3).
-class MMC3 : public Mapper {
+class MMC3 final : public Mapper {
 public:
-    MMC3(NES& nes, NESMetadata metadata, MirroringMode mode);
+    MMC3(Emulator& nes, NESMetadata metadata, MirroringMode mode);
+    MMC3(Emulator& nes, const MMC3& other);
     ~MMC3() = default;
 
 public:
-    /// Tick the mapper.
-    virtual void tick();
+    static constexpr bool LOCKSTEP = true;
+    static constexpr bool WATCH_PPU_A12 = true;
 
     /// Write to a CPU mapped memory bank.
     /// @note This function has other side effects than simply writing to the memory, it
     /// should not be used as a memory set function.
     /// @param address Memory address within the console memory address space.
     /// @param value Value to write.
-    virtual void write_cpu(uint16_t address, uint8_t value);
-
-    /// Write to a PPU mapped memory bank.
-    /// @note This function has other side effects than simply writing to the memory, it
-    /// should not be used as a memory set function.
-    /// @param address Memory address within the console memory address space.
-    /// @param value Value to write.
-    virtual void write_ppu(uint16_t address, uint8_t value);
-
-    /// Read from the PPU memory mapped banks.
-    /// @note This function has other side effects than simply reading from memory, it
-    /// should not be used as a memory watch function.
-    /// @param address Memory address within the console memory address space.
-    /// @return The value stored at the given address.
-    virtual uint8_t read_ppu(uint16_t address);
+    void write_cpu(uint16_t address, uint8_t value);
+
+    /// Notify the mapper of a change of the A12 line of the PPU address bus.
+    /// @note The scanline counter is clocked on rising edges, once the line has been
+    /// low for long enough.
+    /// @param state New state of the line.
+    inline void on_ppu_a12(bool state) {
+        if (state) {
+            if (_line_low && _nes.get_cycle() - _line_low_cycle >= 10) {
+                if (_counter == 0 || _should_reload_interrupt) {
+                    _counter = _counter_reset_value;
+                } else {
+                    _counter--;
+                }
+
+                if (_counter == 0 && _enable_interrupt) {
+                    _nes.set_mapper_interrupt(true);
+                }
+
+                _should_reload_interrupt = false;
+            }
 
-private:
-    void update_state(bool state);
+            _line_low = false;
+        } else if (!_line_low) {
+            _line_low = true;
+            _line_low_cycle = _nes.get_cycle();
+        }
+    }
 
 private:
-    uint32_t _tick;
+    uint64_t _line_low_cycle;
     uint32_t _registers[0x8];
     uint16_t _counter;
     uint16_t _counter_reset_value;
@@ -277,13 +517,14 @@ private:
     bool _mode_chr;
     bool _enable_interrupt;
     bool _should_reload_interrupt;
+    bool _line_low;
 
 public:
     template<DumpOperation operation, typename T>
     constexpr void dump(T& buffer) {
         Mapper::dump<operation>(buffer);
 
-        cynes::dump<operation>(buffer, _tick);
+        cynes::dump<operation>(buffer, _line_low_cycle);
         cynes::dump<operation>(buffer, _registers);
         cynes::dump<operation>(buffer, _counter);
         cynes::dump<operation>(buffer, _counter_reset_value);
@@ -292,14 +533,16 @@ public:
         cynes::dump<operation>(buffer, _mode_chr);
         cynes::dump<operation>(buffer, _enable_interrupt);
         cynes::dump<operation>(buffer, _should_reload_interrupt);
+        cynes::dump<operation>(buffer, _line_low);
     }
 };
 
 
 /// AxROM mapper (see https://www.nesdev.org/wiki/AxROM).
-class AxROM : public Mapper {
+class AxROM final : public Mapper {
 public:
-    AxROM(NES& nes, NESMetadata metadata);
+    AxROM(Emulator& nes, NESMetadata metadata, MirroringMode mode);
+    AxROM(Emulator& nes, const AxROM& other);
     ~AxROM() = default;
 
 public:
@@ -308,14 +551,14 @@ public:
     /// should not be used as a memory set function.
     /// @param address Memory address within the console memory address space.
     /// @param value Value to write.
-    virtual void write_cpu(uint16_t address, uint8_t value);
+    void write_cpu(uint16_t address, uint8_t value);
 };
 
 /// Generic MMC mapper (see https://www.nesdev.org/wiki/MMC2).
 template<uint8_t BANK_SIZE>
-class MMC : public Mapper {
+class MMC final : public Mapper {
 public:
-    MMC(NES& nes, NESMetadata metadata, MirroringMode mode) :
+    MMC(Emulator& nes, NESMetadata metadata, MirroringMode mode) :
         Mapper(nes, metadata, mode) {
         map_bank_chr(0x0, 0x8, 0x0);
 
@@ -328,27 +571,34 @@ public:
         memset(_selected_banks, 0x0, 0x4);
     }
 
+    MMC(Emulator& nes, const MMC& other) : Mapper(nes, other) {
+        memcpy(_latches, other._latches, 0x2);
+        memcpy(_selected_banks, other._selected_banks, 0x4);
+    }
+
     ~MMC() = default;
 
 public:
+    static constexpr bool WATCH_PPU_LATCHES = true;
+
     /// Write to a CPU mapped memory bank.
     /// @note This function has other side effects than simply writing to the memory, it
     /// should not be used as a memory set function.
     /// @param address Memory address within the console memory address space.
     /// @param value Value to write.
-    virtual void write_cpu(uint16_t address, uint8_t value) {
+    void write_cpu(uint16_t address, uint8_t value) {
         if (address < 0xA000) {
             Mapper::write_cpu(address, value);
         } else if (address < 0xB000) {
             map_bank_prg(0x20, BANK_SIZE, (value & 0xF) * BANK_SIZE);
         } else if (address < 0xC000) {
-            _selected_banks[0x0] = value & 0x1F; update_banks();
+            _selected_banks[0x0] = value & 0x1F; update_bank(0x0);
         } else if (address < 0xD000) {
-            _selected_banks[0x1] = value & 0x1F; update_banks();
+            _selected_banks[0x1] = value & 0x1F; update_bank(0x0);
         } else if (address < 0xE000) {
-            _selected_banks[0x2] = value & 0x1F; update_banks();
+            _selected_banks[0x2] = value & 0x1F; update_bank(0x1);
         } else if (address < 0xF000) {
-            _selected_banks[0x3] = value & 0x1F; update_banks();
+            _selected_banks[0x3] = value & 0x1F; update_bank(0x1);
         } else {
             if (value & 0x01) {
                 set_mirroring_mode(MirroringMode::HORIZONTAL);
@@ -358,39 +608,34 @@ public:
         }
     }
 
-    /// Read from the PPU memory mapped banks.
-    /// @note This function has other side effects than simply reading from memory, it
-    /// should not be used as a memory watch function.
-    /// @param address Memory address within the console memory address space.
-    /// @return The value stored at the given address.
-    virtual uint8_t read_ppu(uint16_t address) {
-        uint8_t value = Mapper::read_ppu(address);
-
+    /// Notify the mapper of an access to the PPU address bus near a latch trigger tile.
+    /// @note The latches are switched after the tile has been fetched, the value read
+    /// comes from the previously selected bank.
+    /// @param address Memory address within the PPU address space.
+    inline void on_ppu_latch(uint16_t address) {
         if (address == 0x0FD8) {
-            _latches[0] = true; update_banks();
+            set_latch(0x0, true);
         } else if (address == 0x0FE8) {
-            _latches[0] = false; update_banks();
+            set_latch(0x0, false);
         } else if (address >= 0x1FD8 && address < 0x1FE0) {
-            _latches[1] = true; update_banks();
+            set_latch(0x1, true);
         } else if (address >= 0x1FE8 && address < 0x1FF0) {
-            _latches[1] = false; update_banks();
+            set_latch(0x1, false);
         }
-
-        return value;
     }
 
 private:
-    void update_banks() {
-        if (_latches[0]) {
-            map_bank_chr(0x0, 0x4, _selected_banks[0x0] << 2);
-        } else {
-            map_bank_chr(0x0, 0x4, _selected_banks[0x1] << 2);
+    void set_latch(uint8_t table, bool value) {
+        if (_latches[table] != value) {
+            _latches[table] = value; update_bank(table);
         }
+    }
 
-        if (_latches[1]) {
-            map_bank_chr(0x4, 0x4, _selected_banks[0x2] << 2);
+    void update_bank(uint8_t table) {
+        if (_latches[table]) {
+            map_bank_chr(table << 2, 0x4, _selected_banks[table << 1] << 2);
         } else {
-            map_bank_chr(0x4, 0x4, _selected_banks[0x3] << 2);
+            map_bank_chr(table << 2, 0x4, _selected_banks[(table << 1) | 0x1] << 2);
         }
     }
 
@@ -414,9 +659,10 @@ using MMC4 = MMC<0x10>;
 
 
 /// GxROM mapper (see https://www.nesdev.org/wiki/GxROM).
-class GxROM : public Mapper {
+class GxROM final : public Mapper {
 public:
-    GxROM(NES& nes, NESMetadata metadata, MirroringMode mode);
+    GxROM(Emulator& nes, NESMetadata metadata, MirroringMode mode);
+    GxROM(Emulator& nes, const GxROM& other);
     ~GxROM() = default;
 
 public:
@@ -425,7 +671,7 @@ public:
     /// should not be used as a memory set function.
     /// @param address Memory address within the console memory address space.
     /// @param value Value to write.
-    virtual void write_cpu(uint16_t address, uint8_t value);
+    void write_cpu(uint16_t address, uint8_t value);
 };
 }
 
@@ -4,10 +4,14 @@
 #include "cpu.hpp"
 #include "ppu.hpp"
 #include "mapper.hpp"
+#include "cache.hpp"
+#include "reward.hpp"
+#include "file.hpp"
 
-#include <fstream>
+#include <cstring>
 #include <memory>
 #include <stdexcept>
+#include <vector>
 
 
 constexpr uint8_t PALETTE_RAM_BOOT_VALUES[0x20] = {
@@ -19,26 +23,45 @@ constexpr uint8_t PALETTE_RAM_BOOT_VALUES[0x20] = {
 
 
 // TODO: maybe move elsewhere?
-std::unique_ptr<cynes::Mapper> load_mapper(cynes::NES& nes, const char* path) {
-    std::ifstream stream{path, std::ios::binary};
+std::shared_ptr<uint8_t[]> load_memory(
+    const uint8_t* rom,
+    size_t rom_size,
+    size_t& offset,
+    size_t size
+) {
+    if (offset + size <= rom_size) {
+        offset += size;
+        return cynes::ROMCache::get(rom + offset - size, size);
+    }
+
+    std::vector<uint8_t> memory(size, 0x00);
 
-    if (!stream.is_open()) {
-        throw std::runtime_error("The file cannot be read.");
+    if (offset < rom_size) {
+        std::memcpy(memory.data(), rom + offset, rom_size - offset);
     }
 
-    uint32_t header;
-    stream.read(reinterpret_cast<char*>(&header), 4);
+    offset += size;
+
+    return cynes::ROMCache::get(memory.data(), size);
+}
+
+std::unique_ptr<cynes::Emulator> load_emulator(const uint8_t* rom, size_t rom_size) {
+    uint32_t header = 0;
+
+    if (rom != nullptr && rom_size >= 16) {
+        std::memcpy(&header, rom, 4);
+    }
 
     if (header != 0x1A53454E) {
         throw std::runtime_error("The specified file is not a NES ROM.");
     }
 
-    uint8_t program_banks = stream.get();
-    uint8_t character_banks = stream.get();
-    uint8_t flag6 = stream.get();
-    uint8_t flag7 = stream.get();
+    uint8_t program_banks = rom[4];
+    uint8_t character_banks = rom[5];
+    uint8_t flag6 = rom[6];
+    uint8_t flag7 = rom[7];
 
-    stream.seekg(8, std::ios::cur);
+    size_t offset = 16;
 
     cynes::NESMetadata metadata;
 
@@ -46,29 +69,24 @@ std::unique_ptr<cynes::Mapper> load_mapper(cynes::NES& nes, const char* path) {
     metadata.size_chr = character_banks << 3;
 
     if (flag6 & 0x04) {
-        metadata.trainer = new uint8_t[0x200];
-        stream.read(reinterpret_cast<char*>(metadata.trainer), 0x200);
+        metadata.trainer = load_memory(rom, rom_size, offset, 0x200);
     }
 
     if (metadata.size_prg > 0) {
         size_t memory_size = static_cast<size_t>(metadata.size_prg) << 10;
-        metadata.memory_prg = new uint8_t[memory_size]{ 0 };
-        stream.read(reinterpret_cast<char*>(metadata.memory_prg), memory_size);
+        metadata.memory_prg = load_memory(rom, rom_size, offset, memory_size);
     }
 
     if (metadata.size_chr > 0) {
         size_t memory_size = static_cast<size_t>(metadata.size_chr) << 10;
-        metadata.memory_chr = new uint8_t[memory_size]{ 0 };
-        stream.read(reinterpret_cast<char*>(metadata.memory_chr), memory_size);
+        metadata.memory_chr = load_memory(rom, rom_size, offset, memory_size);
     }
 
     if (metadata.size_chr == 0) {
         metadata.size_chr = 8;
-        metadata.memory_chr = new uint8_t[0x2000]{ 0 };
+        metadata.memory_chr.reset(new uint8_t[0x2000]{ 0 });
     }
 
-    stream.close();
-
     uint8_t mapper_index = (flag7 & 0xF0) | flag6 >> 4;
 
     cynes::MirroringMode mode = (flag6 & 0x01) == 1
@@ -76,30 +94,80 @@ std::unique_ptr<cynes::Mapper> load_mapper(cynes::NES& nes, const char* path) {
         : cynes::MirroringMode::HORIZONTAL;
 
     switch (mapper_index) {
-    case   0: return std::make_unique<cynes::NROM> (nes, metadata, mode);
-    case   1: return std::make_unique<cynes::MMC1> (nes, metadata, mode);
-    case   2: return std::make_unique<cynes::UxROM>(nes, metadata, mode);
-    case   3: return std::make_unique<cynes::CNROM>(nes, metadata, mode);
-    case   4: return std::make_unique<cynes::MMC3> (nes, metadata, mode);
-    case   7: return std::make_unique<cynes::AxROM>(nes, metadata);
-    case   9: return std::make_unique<cynes::MMC2> (nes, metadata, mode);
-    case  10: return std::make_unique<cynes::MMC4> (nes, metadata, mode);
-    case  66: return std::make_unique<cynes::GxROM>(nes, metadata, mode);
-    case  71: return std::make_unique<cynes::UxROM>(nes, metadata, mode);
+    case   0: return std::make_unique<cynes::NESCore<cynes::NROM>>(metadata, mode);
+    case   1: return std::make_unique<cynes::NESCore<cynes::MMC1>>(metadata, mode);
+    case   2: return std::make_unique<cynes::NESCore<cynes::UxROM>>(metadata, mode);
+    case   3: return std::make_unique<cynes::NESCore<cynes::CNROM>>(metadata, mode);
+    case   4: return std::make_unique<cynes::NESCore<cynes::MMC3>>(metadata, mode);
+    case   7: return std::make_unique<cynes::NESCore<cynes::AxROM>>(metadata, mode);
+    case   9: return std::make_unique<cynes::NESCore<cynes::MMC2>>(metadata, mode);
+    case  10: return std::make_unique<cynes::NESCore<cynes::MMC4>>(metadata, mode);
+    case  66: return std::make_unique<cynes::NESCore<cynes::GxROM>>(metadata, mode);
+    case  71: return std::make_unique<cynes::NESCore<cynes::UxROM>>(metadata, mode);
     default: throw std::runtime_error("The ROM Mapper is not supported.");
     }
 }
 
+std::unique_ptr<cynes::Emulator> load_emulator(const char* path) {
+    cynes::MappedFile file{path};
 
-cynes::NES::NES(const char* path)
+    return load_emulator(file.data(), file.size());
+}
+
+
+template<class MapperType>
+cynes::NESCore<MapperType>::NESCore(NESMetadata metadata, MirroringMode mode)
     : cpu{*this}
     , ppu{*this}
     , apu{*this}
-    , _mapper{load_mapper(static_cast<NES&>(*this), path)}
+    , _mapper{*this, metadata, mode}
+    , _target_cycle{0}
+    , _event_cycle{0}
+    , _bus_effects{SIDE_EFFECT}
+    , _ppu_a12{true}
     , _memory_cpu{new uint8_t[0x800]}
     , _memory_oam{new uint8_t[0x100]}
     , _memory_palette{new uint8_t[0x20]}
 {
+    _mapper.map_console_ram(_memory_cpu.get());
+
+    power();
+}
+
+template<class MapperType>
+cynes::NESCore<MapperType>::NESCore(const NESCore& nes)
+    : cpu{*this, nes.cpu}
+    , ppu{*this, nes.ppu}
+    , apu{*this, nes.apu}
+    , _mapper{*this, nes._mapper}
+    , _target_cycle{nes._target_cycle}
+    , _event_cycle{nes._event_cycle}
+    , _bus_effects{SIDE_EFFECT}
+    , _ppu_a12{nes._ppu_a12}
+    , _memory_cpu{new uint8_t[0x800]}
+    , _memory_oam{new uint8_t[0x100]}
+    , _memory_palette{new uint8_t[0x20]}
+{
+    _mapper.map_console_ram(_memory_cpu.get());
+
+    _open_bus = nes._open_bus;
+    _cycle = nes._cycle;
+    _render_skip = nes._render_skip;
+
+    std::memcpy(_memory_cpu.get(), nes._memory_cpu.get(), 0x800);
+    std::memcpy(_memory_oam.get(), nes._memory_oam.get(), 0x100);
+    std::memcpy(_memory_palette.get(), nes._memory_palette.get(), 0x20);
+    std::memcpy(_controller_status, nes._controller_status, 0x2);
+    std::memcpy(_controller_shifters, nes._controller_shifters, 0x2);
+}
+
+template<class MapperType>
+std::unique_ptr<cynes::Emulator> cynes::NESCore<MapperType>::clone() const {
+    return std::make_unique<NESCore>(*this);
+}
+
+template<class MapperType>
+void cynes::NESCore<MapperType>::power() {
     cpu.power();
     ppu.power();
     apu.power();
@@ -115,54 +183,72 @@ cynes::NES::NES(const char* path)
     }
 }
 
-void cynes::NES::reset() {
+template<class MapperType>
+void cynes::NESCore<MapperType>::reset() {
+    sync_ppu();
+
     cpu.reset();
     ppu.reset();
     apu.reset();
 
+    _event_cycle = 0;
+
     for (int i = 0; i < 8; i++) {
         dummy_read();
     }
 }
 
-void cynes::NES::dummy_read() {
+template<class MapperType>
+void cynes::NESCore<MapperType>::dummy_read() {
     apu.tick(true);
-    ppu.tick();
-    ppu.tick();
-    ppu.tick();
-    cpu.poll();
+    tick_ppu();
+    tick_ppu();
+    tick_ppu();
+    poll_cpu();
 }
 
-void cynes::NES::write(uint16_t address, uint8_t value) {
+template<class MapperType>
+void cynes::NESCore<MapperType>::write(uint16_t address, uint8_t value) {
     apu.tick(false);
-    ppu.tick();
-    ppu.tick();
+    tick_ppu();
+    tick_ppu();
 
     write_cpu(address, value);
 
-    ppu.tick();
-    cpu.poll();
+    tick_ppu();
+    poll_cpu();
 }
 
-void cynes::NES::write_cpu(uint16_t address, uint8_t value) {
-    if (address < 0x2000) {
-        _memory_cpu[address & 0x7FF] = value;
-    } else if (address < 0x4000) {
+template<class MapperType>
+void cynes::NESCore<MapperType>::write_cpu(uint16_t address, uint8_t value) {
+    _bus_effects |= SIDE_EFFECT;
+
+    if (uint8_t* page = _mapper.get_page_write(address)) {
+        page[address & 0xFF] = value;
+        return;
+    }
+
+    if (address < 0x4000) {
+        sync_ppu();
         ppu.write(address & 0x7, value);
     } else if (address == 0x4016) {
         load_controller_shifter(~value & 0x01);
     } else if (address < 0x4018) {
         apu.write(address & 0xFF, value);
+    } else if (address >= 0x8000) {
+        sync_ppu();
     }
 
-    _mapper->write_cpu(address, value);
+    _mapper.write_cpu(address, value);
 }
 
-void cynes::NES::write_ppu(uint16_t address, uint8_t value) {
+template<class MapperType>
+void cynes::NESCore<MapperType>::write_ppu(uint16_t address, uint8_t value) {
     address &= 0x3FFF;
 
     if (address < 0x3F00) {
-        _mapper->write_ppu(address, value);
+        watch_ppu_a12(address);
+        _mapper.write_ppu(address, value);
     } else {
         address &= 0x1F;
 
@@ -180,44 +266,56 @@ void cynes::NES::write_ppu(uint16_t address, uint8_t value) {
     }
 }
 
-void cynes::NES::write_oam(uint8_t address, uint8_t value) {
+template<class MapperType>
+void cynes::NESCore<MapperType>::write_oam(uint8_t address, uint8_t value) {
     _memory_oam[address] = value;
 }
 
-uint8_t cynes::NES::read(uint16_t address) {
+template<class MapperType>
+uint8_t cynes::NESCore<MapperType>::read(uint16_t address) {
     apu.tick(true);
-    ppu.tick();
-    ppu.tick();
+    tick_ppu();
+    tick_ppu();
 
     _open_bus = read_cpu(address);
 
-    ppu.tick();
-    cpu.poll();
+    tick_ppu();
+    poll_cpu();
 
     return _open_bus;
 }
 
-uint8_t cynes::NES::read_cpu(uint16_t address) {
-    if (address < 0x2000) {
-        return _memory_cpu[address & 0x7FF];
-    } else if (address < 0x4000) {
+template<class MapperType>
+uint8_t cynes::NESCore<MapperType>::read_cpu(uint16_t address) {
+    if (const uint8_t* page = _mapper.get_page_read(address)) {
+        return page[address & 0xFF];
+    }
+
+    if (address < 0x4000) {
+        _bus_effects |= (address & 0x7) == 0x2 ? STATUS_POLLED : SIDE_EFFECT;
+
+        sync_ppu();
         return ppu.read(address & 0x7);
     } else if (address == 0x4016) {
+        _bus_effects |= SIDE_EFFECT;
         return poll_controller(0x0);
     } else if (address == 0x4017) {
+        _bus_effects |= SIDE_EFFECT;
         return poll_controller(0x1);
     } else if (address < 0x4018) {
+        _bus_effects |= SIDE_EFFECT;
         return apu.read(address & 0xFF);
     } else {
-        return _mapper->read_cpu(address);
+        return _mapper.read_cpu(address);
     }
 }
 
-uint8_t cynes::NES::read_ppu(uint16_t address) {
+template<class MapperType>
+uint8_t cynes::NESCore<MapperType>::read_ppu(uint16_t address) {
     address &= 0x3FFF;
 
     if (address < 0x3F00) {
-        return _mapper->read_ppu(address);
+        return fetch_ppu(address);
     } else {
         address &= 0x1F;
 
@@ -235,57 +333,167 @@ uint8_t cynes::NES::read_ppu(uint16_t address) {
     }
 }
 
-uint8_t cynes::NES::read_oam(uint8_t address) const {
+template<class MapperType>
+uint8_t cynes::NESCore<MapperType>::read_oam(uint8_t address) const {
     return _memory_oam[address];
 }
 
-uint8_t cynes::NES::get_open_bus() const {
-    return _open_bus;
+template<class MapperType>
+const uint8_t* cynes::NESCore<MapperType>::get_memory(MemoryRegion region) const {
+    switch (region) {
+    case MemoryRegion::RAM: return _memory_cpu.get();
+    case MemoryRegion::PRG_RAM: return _mapper.get_cpu_ram();
+    case MemoryRegion::VRAM: return _mapper.get_ppu_ram();
+    case MemoryRegion::OAM: return _memory_oam.get();
+    case MemoryRegion::PALETTE: return _memory_palette.get();
+    default: return nullptr;
+    }
 }
 
-bool cynes::NES::step(uint16_t controllers, unsigned int frames) {
+template<class MapperType>
+size_t cynes::NESCore<MapperType>::get_memory_size(MemoryRegion region) const {
+    switch (region) {
+    case MemoryRegion::RAM: return 0x800;
+    case MemoryRegion::PRG_RAM: return _mapper.get_cpu_ram_size();
+    case MemoryRegion::VRAM: return _mapper.get_ppu_ram_size();
+    case MemoryRegion::OAM: return 0x100;
+    case MemoryRegion::PALETTE: return 0x20;
+    default: return 0;
+    }
+}
+
+template<class MapperType>
+void cynes::NESCore<MapperType>::peek(uint16_t address, uint8_t* values, size_t size) const {
+    for (size_t k = 0; k < size; k++, address++) {
+        if (const uint8_t* page = _mapper.get_page_read(address)) {
+            values[k] = page[address & 0xFF];
+        } else if (address < 0x4018) {
+            values[k] = _open_bus;
+        } else {
+            values[k] = _mapper.peek_cpu(address);
+        }
+    }
+}
+
+template<class MapperType>
+void cynes::NESCore<MapperType>::poke(uint16_t address, const uint8_t* values, size_t size) {
+    for (size_t k = 0; k < size; k++, address++) {
+        if (uint8_t* page = _mapper.get_page_write(address)) {
+            page[address & 0xFF] = values[k];
+        } else if (address >= 0x4018) {
+            _mapper.poke_cpu(address, values[k]);
+        }
+    }
+}
+
+template<class MapperType>
+bool cynes::NESCore<MapperType>::step(uint16_t controllers, unsigned int frames) {
     _controller_status[0x0] = controllers & 0xFF;
     _controller_status[0x1] = controllers >> 8;
 
     for (unsigned int k = 0; k < frames; k++) {
+        ppu.set_render_skip(_render_skip && k + 1 < frames);
+
         while (!ppu.is_frame_ready()) {
             cpu.tick();
 
             if (cpu.is_frozen()) {
+                ppu.set_render_skip(false);
+                sync_ppu();
                 return true;
             }
+
+            _instructions++;
+        }
+
+        if (_reward_function) {
+            _reward_function->update(*this);
         }
     }
 
+    sync_ppu();
     return false;
 }
 
-unsigned int cynes::NES::size() {
+template<class MapperType>
+unsigned int cynes::NESCore<MapperType>::size() {
     unsigned int buffer_size = 0;
     dump<DumpOperation::SIZE>(buffer_size);
 
     return buffer_size;
 }
 
-void cynes::NES::save(uint8_t* buffer) {
+template<class MapperType>
+void cynes::NESCore<MapperType>::save(uint8_t* buffer) {
+    sync_ppu();
     dump<DumpOperation::DUMP>(buffer);
 }
 
-void cynes::NES::load(uint8_t* buffer) {
+template<class MapperType>
+void cynes::NESCore<MapperType>::load(uint8_t* buffer) {
     dump<DumpOperation::LOAD>(buffer);
+
+    _target_cycle = _cycle;
+    _event_cycle = 0;
+    _bus_effects = SIDE_EFFECT;
 }
 
-cynes::Mapper& cynes::NES::get_mapper() {
-    return static_cast<Mapper&>(*_mapper.get());
+template<class MapperType>
+void cynes::NESCore<MapperType>::set_mapper_interrupt(bool interrupt) {
+    cpu.set_mapper_interrupt(interrupt);
 }
 
-void cynes::NES::load_controller_shifter(bool polling) {
+template<class MapperType>
+void cynes::NESCore<MapperType>::sync_ppu() {
+    while (_cycle < _target_cycle) {
+        if constexpr (!MapperType::LOCKSTEP) {
+            if (_target_cycle - _cycle >= 340 && ppu.can_render_scanline()) {
+                ppu.render_scanline();
+                continue;
+            }
+        }
+
+        ppu.tick();
+    }
+
+    _event_cycle = _cycle + ppu.get_event_distance();
+}
+
+template<class MapperType>
+void cynes::NESCore<MapperType>::skip_idle_loop(uint32_t period) {
+    if constexpr (MapperType::LOCKSTEP) {
+        return;
+    }
+
+    if (_target_cycle >= _event_cycle) {
+        return;
+    }
+
+    uint64_t iterations = (_event_cycle - _target_cycle - 1) / period;
+    uint64_t apu_iterations = apu.get_idle_distance() / (period / 3);
+
+    if (apu_iterations < iterations) {
+        iterations = apu_iterations;
+    }
+
+    if (iterations == 0) {
+        return;
+    }
+
+    apu.skip(iterations * (period / 3));
+
+    _target_cycle += iterations * period;
+}
+
+template<class MapperType>
+void cynes::NESCore<MapperType>::load_controller_shifter(bool polling) {
     if (polling) {
         memcpy(_controller_shifters, _controller_status, 0x2);
     }
 }
 
-uint8_t cynes::NES::poll_controller(uint8_t player) {
+template<class MapperType>
+uint8_t cynes::NESCore<MapperType>::poll_controller(uint8_t player) {
     uint8_t value = _controller_shifters[player] >> 7;
 
     _controller_shifters[player] <<= 1;
@@ -293,13 +501,15 @@ uint8_t cynes::NES::poll_controller(uint8_t player) {
     return (_open_bus & 0xE0) | value;
 }
 
+template<class MapperType>
 template<cynes::DumpOperation operation, typename T>
-void cynes::NES::dump(T& buffer) {
-    cpu.dump<operation>(buffer);
-    ppu.dump<operation>(buffer);
-    apu.dump<operation>(buffer);
+void cynes::NESCore<MapperType>::dump(T& buffer) {
+    // The mapper comes first, so that a state it rejects is never partially loaded.
+    _mapper.template dump<operation>(buffer);
 
-    _mapper->dump<operation>(buffer);
+    cpu.template dump<operation>(buffer);
+    ppu.template dump<operation>(buffer);
+    apu.template dump<operation>(buffer);
 
     cynes::dump<operation>(buffer, _memory_cpu.get(), 0x800);
     cynes::dump<operation>(buffer, _memory_oam.get(), 0x100);
@@ -307,8 +517,84 @@ void cynes::NES::dump(T& buffer) {
 
     cynes::dump<operation>(buffer, _controller_status);
     cynes::dump<operation>(buffer, _controller_shifters);
+
+    cynes::dump<operation>(buffer, _open_bus);
+    cynes::dump<operation>(buffer, _cycle);
+    cynes::dump<operation>(buffer, _ppu_a12);
+}
+
+
+cynes::NES::NES(const char* path)
+    : _emulator{load_emulator(path)}
+    , _reward_function{} { }
+
+cynes::NES::NES(const uint8_t* rom, size_t size)
+    : _emulator{load_emulator(rom, size)}
+    , _reward_function{} { }
+
+cynes::NES::NES(const NES& nes)
+    : _emulator{nes._emulator->clone()}
+    , _reward_function{}
+{
+    if (nes._reward_function) {
+        _reward_function = std::make_unique<RewardFunction>(*nes._reward_function);
+        _emulator->set_reward_function(_reward_function.get());
+    }
+}
+
+void cynes::NES::reset() {
+    _emulator->reset();
+
+    if (_reward_function) {
+        _reward_function->clear();
+    }
 }
 
-template void cynes::NES::dump<cynes::DumpOperation::SIZE>(unsigned int&);
-template void cynes::NES::dump<cynes::DumpOperation::DUMP>(uint8_t*&);
-template void cynes::NES::dump<cynes::DumpOperation::LOAD>(uint8_t*&);
+void cynes::NES::write_cpu(uint16_t address, uint8_t value) {
+    _emulator->write_cpu(address, value);
+}
+
+uint8_t cynes::NES::read_cpu(uint16_t address) {
+    return _emulator->read_cpu(address);
+}
+
+bool cynes::NES::step(uint16_t controllers, unsigned int frames) {
+    return _emulator->step(controllers, frames);
+}
+
+unsigned int cynes::NES::size() {
+    return _emulator->size();
+}
+
+void cynes::NES::save(uint8_t* buffer) {
+    _emulator->save(buffer);
+}
+
+void cynes::NES::load(uint8_t* buffer) {
+    _emulator->load(buffer);
+
+    if (_reward_function) {
+        _reward_function->clear();
+    }
+}
+
+void cynes::NES::set_reward_function(const std::string& reward, const std::string& done) {
+    _reward_function = std::make_unique<RewardFunction>(reward, done);
+    _emulator->set_reward_function(_reward_function.get());
+}
+
+void cynes::NES::clear_reward_function() {
+    _emulator->set_reward_function(nullptr);
+    _reward_function.reset();
+}
+
+
+template class cynes::NESCore<cynes::NROM>;
+template class cynes::NESCore<cynes::MMC1>;
+template class cynes::NESCore<cynes::UxROM>;
+template class cynes::NESCore<cynes::CNROM>;
+template class cynes::NESCore<cynes::MMC3>;
+template class cynes::NESCore<cynes::AxROM>;
+template class cynes::NESCore<cynes::MMC2>;
+template class cynes::NESCore<cynes::MMC4>;
+template class cynes::NESCore<cynes::GxROM>;
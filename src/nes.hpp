@@ -1,29 +1,48 @@
 #ifndef __CYNES_EMULATOR__
 #define __CYNES_EMULATOR__
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <string>
 
+#include "emulator.hpp"
 #include "apu.hpp"
 #include "cpu.hpp"
 #include "ppu.hpp"
 #include "mapper.hpp"
+#include "reward.hpp"
 
 #include "utils.hpp"
 
 namespace cynes {
 /// Main NES class, contains the RAM, CPU, PPU, APU, Mapper, etc...
-class NES {
+/// The emulation core is specialized at compile time for the mapper used by the ROM,
+/// so that the bus dispatch and the mapper ticks do not go through virtual calls.
+template<class MapperType>
+class NESCore final : public Emulator {
 public:
-    // TODO maybe allow to use a constructor with a raw byte ptr.
     /// Initialize the NES.
-    /// @param path Path to the ROM.
-    NES(const char* path);
+    /// @param metadata ROM metadata.
+    /// @param mode Mapper mirroring mode.
+    NESCore(NESMetadata metadata, MirroringMode mode);
+
+    /// Initialize the NES as a copy of another NES.
+    /// @note The ROM memory is shared between both emulators, every other component
+    /// state is duplicated.
+    /// @param nes Emulator to copy.
+    NESCore(const NESCore& nes);
 
     /// Default destructor.
-    ~NES() = default;
+    ~NESCore() = default;
+
+    NESCore& operator=(const NESCore&) = delete;
 
 public:
+    /// Create a copy of the emulator sharing the same ROM memory.
+    /// @return The copied emulator.
+    std::unique_ptr<Emulator> clone() const;
+
     /// Reset the emulator (same effect as pressing the reset button).
     void reset();
 
@@ -72,6 +91,24 @@ public:
     /// @return The value stored at the given address.
     uint8_t read_cpu(uint16_t address);
 
+    /// Perform a read cycle on PRG ROM, whose value is already known by the caller.
+    /// @note PRG ROM reads have no side effect besides updating the open bus, so the
+    /// address decoding can be skipped.
+    /// @param value Value stored at the address read.
+    /// @return The value read.
+    inline uint8_t fetch(uint8_t value) {
+        apu.tick(true);
+        tick_ppu();
+        tick_ppu();
+
+        _open_bus = value;
+
+        tick_ppu();
+        poll_cpu();
+
+        return _open_bus;
+    }
+
     /// Read from the PPU memory.
     /// @note This function has other side effects than simply reading from memory, it
     /// should not be used as a memory watch function.
@@ -79,6 +116,62 @@ public:
     /// @return The value stored at the given address.
     uint8_t read_ppu(uint16_t address);
 
+    /// Fetch a pattern or nametable byte for the rendering pipeline of the PPU.
+    /// @note The byte is read directly from the PPU page table of the mapper, which is
+    /// only notified of the access if it observes the PPU address bus.
+    /// @param address Memory address within the PPU address space, below $3F00.
+    /// @return The value stored at the given address.
+    inline uint8_t fetch_ppu(uint16_t address) {
+        uint8_t value = _mapper.get_page_ppu(address)[address & 0x3FF];
+
+        watch_ppu_bus(address);
+
+        return value;
+    }
+
+    /// Fetch the high plane of a pattern row for the rendering pipeline of the PPU, and
+    /// get the whole decoded row.
+    /// @param address Memory address of the high plane of the row, below $2000.
+    /// @param row Row holding the low plane fetched earlier, in its even bits.
+    /// @param flip True to fetch the horizontally mirrored row.
+    /// @return The row, 2 bits per pixel with the leftmost pixel in the upper bits.
+    inline uint16_t fetch_tile_row(uint16_t address, uint16_t row, bool flip) {
+        uint16_t value = _mapper.read_tile_row(address, row, flip);
+
+        watch_ppu_bus(address);
+
+        return value;
+    }
+
+    /// Notify the mapper of a read on the PPU address bus, if it observes it.
+    /// @note Mappers are only notified on A12 transitions, or on reads near their latch
+    /// trigger tiles.
+    /// @param address Memory address within the PPU address space, below $3F00.
+    inline void watch_ppu_bus(uint16_t address) {
+        watch_ppu_a12(address);
+
+        if constexpr (MapperType::WATCH_PPU_LATCHES) {
+            if ((address & 0x0FF8) == 0x0FD8 || (address & 0x0FF8) == 0x0FE8) {
+                _mapper.on_ppu_latch(address);
+            }
+        }
+    }
+
+    /// Notify the mapper of a transition of the A12 line of the PPU address bus, if it
+    /// observes it.
+    /// @note Unlike reads, writes to the PPU memory never trigger the mapper latches.
+    /// @param address Memory address within the PPU address space, below $3F00.
+    inline void watch_ppu_a12(uint16_t address) {
+        if constexpr (MapperType::WATCH_PPU_A12) {
+            bool a12 = address & 0x1000;
+
+            if (a12 != _ppu_a12) {
+                _ppu_a12 = a12;
+                _mapper.on_ppu_a12(a12);
+            }
+        }
+    }
+
     /// Read from the OAM memory.
     /// @note This function has other side effects than simply reading from memory, it
     /// should not be used as a memory watch function.
@@ -86,10 +179,6 @@ public:
     /// @return The value stored at the given address.
     uint8_t read_oam(uint8_t address) const;
 
-    /// Get the current open bus state.
-    /// @return The open bus value.
-    uint8_t get_open_bus() const;
-
     /// Step the emulation by the given amount of frame.
     /// @param controllers Controllers states (first 8-bits for controller 1, the
     /// remaining 8-bits fro controller 2).
@@ -114,27 +203,175 @@ public:
         return ppu.get_frame_buffer();
     }
 
+    /// Get a pointer to the internal palette index buffer.
+    inline const uint8_t* get_index_buffer() const {
+        return ppu.get_index_buffer();
+    }
+
+    /// Get a pointer to the color emphasis bits of each scanline.
+    inline const uint8_t* get_emphasis_buffer() const {
+        return ppu.get_emphasis_buffer();
+    }
+
+    /// Set the format of the pixels output by the PPU.
+    /// @param format New frame format.
+    inline void set_frame_format(FrameFormat format) {
+        ppu.set_frame_format(format);
+    }
+
+    /// Get the format of the pixels output by the PPU.
+    /// @return The current frame format.
+    inline FrameFormat get_frame_format() const {
+        return ppu.get_frame_format();
+    }
+
+    /// Convert the palette index buffer to RGB colors, in the frame buffer.
+    inline void convert_frame_buffer() {
+        ppu.convert_frame_buffer();
+    }
+
+    /// Redirect the pixels output by the PPU to an external buffer.
+    /// @param target Output buffer, or a null pointer to restore the internal buffers.
+    inline void set_frame_target(uint8_t* target) {
+        sync_ppu();
+        ppu.set_frame_target(target);
+    }
+
+    /// Get a pointer to one of the memory regions of the console.
+    /// @param region Memory region.
+    /// @return A pointer to the memory, or a null pointer if the region is empty.
+    const uint8_t* get_memory(MemoryRegion region) const;
+
+    /// Get the size of one of the memory regions of the console.
+    /// @param region Memory region.
+    /// @return The size of the memory in bytes.
+    size_t get_memory_size(MemoryRegion region) const;
+
+    /// Read a range of the console memory without side effect.
+    /// @note Memory mapped registers are not read, the open bus value is returned
+    /// instead.
+    /// @param address First memory address within the console memory address space.
+    /// @param values Output buffer.
+    /// @param size Number of bytes to read.
+    void peek(uint16_t address, uint8_t* values, size_t size) const;
+
+    /// Write a range of the console memory without side effect.
+    /// @note Writes to memory mapped registers and to ROM are ignored.
+    /// @param address First memory address within the console memory address space.
+    /// @param values Values to write.
+    /// @param size Number of bytes to write.
+    void poke(uint16_t address, const uint8_t* values, size_t size);
+
+    /// Set the state of the mapper interrupt line.
+    /// @param interrupt Interrupt state.
+    void set_mapper_interrupt(bool interrupt);
+
+    /// Advance the global cycle counter by one PPU dot.
+    inline void advance_cycle() {
+        _cycle++;
+    }
+
+    /// Advance the global cycle counter by several PPU dots.
+    /// @param dots Number of dots.
+    inline void advance_cycle(uint32_t dots) {
+        _cycle += dots;
+    }
+
+    /// Advance the PPU clock by one dot.
+    /// @note Unless the mapper requires the PPU to run in lockstep, the dot is only
+    /// recorded, the PPU catches up when one of its side effects can be observed.
+    inline void tick_ppu() {
+        _target_cycle++;
+
+        if constexpr (MapperType::LOCKSTEP) {
+            ppu.tick();
+        }
+    }
+
+    /// Poll the CPU for interrupts, running the PPU first if it may have changed the
+    /// non-maskable interrupt line or completed a frame.
+    inline void poll_cpu() {
+        if (_target_cycle >= _event_cycle) {
+            sync_ppu();
+        }
+
+        cpu.poll();
+    }
+
+    /// Run the PPU until it catches up with the CPU.
+    void sync_ppu();
+
+    /// Bus accesses recorded since the last call to `NESCore::clear_bus_effects`.
+    enum BusEffect : uint8_t {
+        STATUS_POLLED = 0x01, SIDE_EFFECT = 0x02
+    };
+
+    /// Get the bus accesses recorded since the last call to `clear_bus_effects`.
+    /// @note Writes and reads of memory mapped registers count as side effects, except
+    /// for reads of the PPU status register, which are reported separately.
+    /// @return A combination of `BusEffect` flags.
+    inline uint8_t get_bus_effects() const {
+        return _bus_effects;
+    }
+
+    /// Clear the bus accesses record.
+    inline void clear_bus_effects() {
+        _bus_effects = 0x00;
+    }
+
+    /// Get the global cycle counter as seen by the CPU.
+    /// @note Unlike `get_cycle`, the counter is not behind the CPU while the PPU is
+    /// waiting to catch up.
+    /// @return The number of PPU dots emulated or pending since power-up.
+    inline uint64_t get_target_cycle() const {
+        return _target_cycle;
+    }
+
+    /// Get the cycle of the next PPU event the CPU has to wait for.
+    /// @note The value only changes once the PPU has reached the event, or when a
+    /// register access has changed its timing.
+    /// @return The global cycle of the next event.
+    inline uint64_t get_event_cycle() const {
+        return _event_cycle;
+    }
+
+    /// Fast-forward an idle loop, by skipping as many iterations as possible without
+    /// reaching a PPU or APU event.
+    /// @note The CPU is responsible for checking that the loop has no side effect, and
+    /// that its state is identical from one iteration to the next one.
+    /// @param period Duration of one iteration, in PPU dots.
+    void skip_idle_loop(uint32_t period);
+
 public:
-    CPU cpu;
-    PPU ppu;
-    APU apu;
+    CPU<MapperType> cpu;
+    PPU<MapperType> ppu;
+    APU<MapperType> apu;
 
-    Mapper& get_mapper();
+    inline MapperType& get_mapper() {
+        return _mapper;
+    }
 
 private:
-    std::unique_ptr<Mapper> _mapper;
+    MapperType _mapper;
+
+    uint64_t _target_cycle;
+    uint64_t _event_cycle;
+
+    uint8_t _bus_effects;
+
+    bool _ppu_a12;
 
 private:
     std::unique_ptr<uint8_t[]> _memory_cpu;
     std::unique_ptr<uint8_t[]> _memory_oam;
     std::unique_ptr<uint8_t[]> _memory_palette;
 
-    uint8_t _open_bus;
-
     uint8_t _controller_status[0x2];
     uint8_t _controller_shifters[0x2];
 
 private:
+    void power();
+
     void load_controller_shifter(bool polling);
 
     uint8_t poll_controller(uint8_t player);
@@ -142,6 +379,200 @@ private:
 private:
     template<DumpOperation operation, class T> void dump(T& buffer);
 };
+
+
+/// NES emulator, wraps the emulation core matching the mapper of the loaded ROM.
+class NES {
+public:
+    /// Initialize the NES.
+    /// @note The ROM file is memory mapped while it is parsed.
+    /// @param path Path to the ROM.
+    NES(const char* path);
+
+    /// Initialize the NES from a ROM stored in memory.
+    /// @note The ROM content is copied, the buffer can be released afterward.
+    /// @param rom Content of the ROM file.
+    /// @param size Size of the ROM file.
+    NES(const uint8_t* rom, size_t size);
+
+    /// Initialize the NES as a copy of another NES.
+    /// @note The ROM memory is shared between both emulators, every other component
+    /// state is duplicated.
+    /// @param nes Emulator to copy.
+    NES(const NES& nes);
+
+    /// Initialize the NES by taking over the components of another NES.
+    /// @note The moved-from emulator must not be used afterward.
+    /// @param nes Emulator to move.
+    NES(NES&& nes) = default;
+
+    /// Default destructor.
+    ~NES() = default;
+
+    NES& operator=(const NES&) = delete;
+
+public:
+    /// Reset the emulator (same effect as pressing the reset button).
+    void reset();
+
+    /// Write to the console memory.
+    /// @note This function has other side effects than simply writing to the memory, it
+    /// should not be used as a memory set function.
+    /// @param address Memory address within the console memory address space.
+    /// @param value Value to write.
+    void write_cpu(uint16_t address, uint8_t value);
+
+    /// Read from the console memory.
+    /// @note This function has other side effects than simply reading from memory, it
+    /// should not be used as a memory watch function.
+    /// @param address Memory address within the console memory address space.
+    /// @return The value stored at the given address.
+    uint8_t read_cpu(uint16_t address);
+
+    /// Step the emulation by the given amount of frame.
+    /// @param controllers Controllers states (first 8-bits for controller 1, the
+    /// remaining 8-bits fro controller 2).
+    /// @param frames Number of frame of the step.
+    /// @return True if the CPU is frozen, false otherwise.
+    bool step(uint16_t controllers, unsigned int frames);
+
+    /// Get the size of the save state.
+    /// @return The size of the save state buffer.
+    unsigned int size();
+
+    /// Save the state of the emulator to the buffer.
+    /// @param buffer Save state buffer.
+    void save(uint8_t* buffer);
+
+    /// Load a previous emulator state from the buffer.
+    /// @note A state whose memory banks do not match the loaded ROM is rejected with a
+    /// runtime error, the emulator is then left unchanged.
+    /// @param buffer Save state buffer.
+    void load(uint8_t* buffer);
+
+    /// Get a pointer to the internal frame buffer.
+    inline const uint8_t* get_frame_buffer() const {
+        return _emulator->get_frame_buffer();
+    }
+
+    /// Get a pointer to the internal palette index buffer (240x256).
+    /// @note The buffer is only written while the frame format is `FrameFormat::PALETTE`.
+    inline const uint8_t* get_index_buffer() const {
+        return _emulator->get_index_buffer();
+    }
+
+    /// Get a pointer to the color emphasis bits of each scanline (240).
+    /// @note The buffer is only written while the frame format is `FrameFormat::PALETTE`.
+    inline const uint8_t* get_emphasis_buffer() const {
+        return _emulator->get_emphasis_buffer();
+    }
+
+    /// Set the format of the pixels output by the PPU.
+    /// @note In `FrameFormat::PALETTE` mode, the frame buffer is no longer written and
+    /// only holds the result of the last call to `NES::convert_frame_buffer`.
+    /// @param format New frame format.
+    inline void set_frame_format(FrameFormat format) {
+        _emulator->set_frame_format(format);
+    }
+
+    /// Get the format of the pixels output by the PPU.
+    /// @return The current frame format.
+    inline FrameFormat get_frame_format() const {
+        return _emulator->get_frame_format();
+    }
+
+    /// Convert the palette index buffer to RGB colors, in the frame buffer.
+    inline void convert_frame_buffer() {
+        _emulator->convert_frame_buffer();
+    }
+
+    /// Redirect the pixels output by the PPU to an external buffer, so that frames are
+    /// rendered in place instead of being copied out of the internal buffers.
+    /// @note The target must hold a whole frame in the current frame format (see
+    /// `PPU::set_frame_target`). While it is set, the internal frame buffer and palette
+    /// index buffer are left untouched, the emphasis buffer is still written.
+    /// @param target Output buffer, or a null pointer to restore the internal buffers.
+    inline void set_frame_target(uint8_t* target) {
+        _emulator->set_frame_target(target);
+    }
+
+    /// Get a pointer to one of the memory regions of the console.
+    /// @note The pointer stays valid for the whole lifetime of the emulator, the memory
+    /// can be watched across steps and state loads. It is read-only, the pattern tiles
+    /// held in VRAM are cached decoded by the PPU.
+    /// @param region Memory region.
+    /// @return A pointer to the memory, or a null pointer if the region is empty.
+    inline const uint8_t* get_memory(MemoryRegion region) const {
+        return _emulator->get_memory(region);
+    }
+
+    /// Get the size of one of the memory regions of the console.
+    /// @param region Memory region.
+    /// @return The size of the memory in bytes.
+    inline size_t get_memory_size(MemoryRegion region) const {
+        return _emulator->get_memory_size(region);
+    }
+
+    /// Read a range of the console memory without side effect.
+    /// @note Unlike `NES::read_cpu`, the components are not ticked and memory mapped
+    /// registers are not read, the open bus value is returned instead.
+    /// @param address First memory address within the console memory address space.
+    /// @param values Output buffer.
+    /// @param size Number of bytes to read.
+    inline void peek(uint16_t address, uint8_t* values, size_t size) const {
+        _emulator->peek(address, values, size);
+    }
+
+    /// Write a range of the console memory without side effect.
+    /// @note Unlike `NES::write_cpu`, the components are not ticked and writes to memory
+    /// mapped registers and to ROM are ignored.
+    /// @param address First memory address within the console memory address space.
+    /// @param values Values to write.
+    /// @param size Number of bytes to write.
+    inline void poke(uint16_t address, const uint8_t* values, size_t size) {
+        _emulator->poke(address, values, size);
+    }
+
+    /// Enable or disable the rendering of intermediate frames (see
+    /// `Emulator::set_render_skip`).
+    /// @param skip True to only render the last frame of a step, false otherwise.
+    inline void set_render_skip(bool skip) {
+        _emulator->set_render_skip(skip);
+    }
+
+    /// Check whether or not intermediate frames are skipped.
+    /// @return True if only the last frame of a step is rendered, false otherwise.
+    inline bool get_render_skip() const {
+        return _emulator->get_render_skip();
+    }
+
+    /// Get the number of instructions executed by the CPU (see
+    /// `Emulator::get_instruction_count`).
+    /// @return The number of instructions executed since the emulator was created.
+    inline uint64_t get_instruction_count() const {
+        return _emulator->get_instruction_count();
+    }
+
+    /// Attach a reward function, evaluated after every frame (see `RewardFunction`).
+    /// @note The history of the function is cleared whenever the emulator is reset or
+    /// loaded.
+    /// @param reward Reward expression (see `MemoryExpression`).
+    /// @param done Termination expression.
+    void set_reward_function(const std::string& reward, const std::string& done);
+
+    /// Detach the reward function.
+    void clear_reward_function();
+
+    /// Get the reward function.
+    /// @return The reward function, or a null pointer if none is attached.
+    inline RewardFunction* get_reward_function() const {
+        return _reward_function.get();
+    }
+
+private:
+    std::unique_ptr<Emulator> _emulator;
+    std::unique_ptr<RewardFunction> _reward_function;
+};
 }
 
 #endif
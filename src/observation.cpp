@@ -0,0 +1,306 @@
+#include "observation.hpp"
+#include "nes.hpp"
+#include "ppu.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+
+// Fixed-point ITU-R BT.601 luma, with the same rounding as OpenCV.
+inline uint8_t get_luma(const uint8_t* color) {
+    return (color[0] * 4899 + color[1] * 9617 + color[2] * 1868 + 8192) >> 14;
+}
+
+
+cynes::ObservationPipeline::ObservationPipeline(const ObservationConfig& config)
+    : _config{config}
+    , _crop_width{0}
+    , _crop_height{0}
+    , _channels{static_cast<uint8_t>(config.grayscale ? 1 : 3)}
+    , _capture_buffers{}
+    , _previous_captured{false}
+    , _resize_x{}
+    , _resize_y{}
+    , _resize_buffer{}
+    , _frames{}
+    , _frame_head{0}
+    , _frames_empty{true}
+{
+    if (config.width == 0 || config.height == 0) {
+        throw std::runtime_error("The observation size must be positive.");
+    }
+
+    if (config.stack == 0) {
+        throw std::runtime_error("The number of stacked frames must be positive.");
+    }
+
+    if (config.crop_top + config.crop_bottom >= 240 || config.crop_left + config.crop_right >= 256) {
+        throw std::runtime_error("The crop is larger than the frame.");
+    }
+
+    _crop_width = 256 - config.crop_left - config.crop_right;
+    _crop_height = 240 - config.crop_top - config.crop_bottom;
+
+    for (uint8_t emphasis = 0; emphasis < 0x8; emphasis++) {
+        for (uint8_t index = 0; index < 0x40; index++) {
+            _gray_colors[emphasis][index] = get_luma(get_palette_color(index, emphasis));
+        }
+    }
+
+    _capture_buffers.reset(new uint8_t[get_capture_size() * 2]);
+
+    _resize_x = get_resize_axis(_crop_width, config.width);
+    _resize_y = get_resize_axis(_crop_height, config.height);
+    _resize_buffer.reset(new float[static_cast<size_t>(config.height) * _crop_width * _channels]);
+
+    _frames.reset(new uint8_t[get_frame_size() * config.stack]);
+}
+
+cynes::ObservationPipeline::ObservationPipeline(const ObservationPipeline& other)
+    : ObservationPipeline{other._config}
+{
+    std::memcpy(_frames.get(), other._frames.get(), get_frame_size() * _config.stack);
+
+    _frame_head = other._frame_head;
+    _frames_empty = other._frames_empty;
+}
+
+bool cynes::ObservationPipeline::step(
+    NES& nes,
+    uint16_t controllers,
+    unsigned int frames,
+    uint8_t* observation
+) {
+    bool frozen;
+
+    if (_config.max_pool && frames > 1) {
+        frozen = nes.step(controllers, frames - 1);
+        capture_previous(nes);
+
+        if (!frozen) {
+            frozen = nes.step(controllers, 1);
+        }
+    } else {
+        frozen = nes.step(controllers, frames);
+    }
+
+    update(nes, observation);
+
+    return frozen;
+}
+
+void cynes::ObservationPipeline::capture_previous(const NES& nes) {
+    if (!_config.max_pool) {
+        return;
+    }
+
+    capture(nes, _capture_buffers.get() + get_capture_size());
+
+    _previous_captured = true;
+}
+
+void cynes::ObservationPipeline::update(const NES& nes, uint8_t* observation) {
+    size_t capture_size = get_capture_size();
+    size_t frame_size = get_frame_size();
+
+    uint8_t* current = _capture_buffers.get();
+
+    capture(nes, current);
+
+    if (_previous_captured) {
+        const uint8_t* previous = current + capture_size;
+
+        for (size_t k = 0; k < capture_size; k++) {
+            current[k] = std::max(current[k], previous[k]);
+        }
+
+        _previous_captured = false;
+    }
+
+    if (_frames_empty) {
+        resize(current, _frames.get());
+
+        for (uint8_t slot = 1; slot < _config.stack; slot++) {
+            std::memcpy(_frames.get() + slot * frame_size, _frames.get(), frame_size);
+        }
+
+        _frame_head = 0;
+        _frames_empty = false;
+    } else {
+        _frame_head = (_frame_head + 1) % _config.stack;
+
+        resize(current, _frames.get() + _frame_head * frame_size);
+    }
+
+    write(observation);
+}
+
+void cynes::ObservationPipeline::clear() {
+    _frames_empty = true;
+    _previous_captured = false;
+}
+
+size_t cynes::ObservationPipeline::size() const {
+    return get_frame_size() * _config.stack;
+}
+
+size_t cynes::ObservationPipeline::get_capture_size() const {
+    return static_cast<size_t>(_crop_width) * _crop_height * _channels;
+}
+
+size_t cynes::ObservationPipeline::get_frame_size() const {
+    return static_cast<size_t>(_config.width) * _config.height * _channels;
+}
+
+cynes::ObservationPipeline::ResizeAxis cynes::ObservationPipeline::get_resize_axis(
+    uint16_t source,
+    uint16_t destination
+) {
+    ResizeAxis axis;
+
+    double scale = static_cast<double>(source) / destination;
+
+    for (uint16_t index = 0; index < destination; index++) {
+        uint16_t first = static_cast<uint16_t>(std::floor(index * scale));
+        uint16_t last = static_cast<uint16_t>(std::min<double>(std::ceil((index + 1) * scale), source));
+
+        axis.taps = std::max<uint16_t>(axis.taps, last - first);
+    }
+
+    axis.offsets.resize(destination);
+    axis.weights.resize(static_cast<size_t>(destination) * axis.taps, 0.0f);
+
+    for (uint16_t index = 0; index < destination; index++) {
+        double begin = index * scale;
+        double end = std::min<double>((index + 1) * scale, source);
+
+        uint16_t first = std::min<uint16_t>(static_cast<uint16_t>(std::floor(begin)), source - axis.taps);
+
+        axis.offsets[index] = first;
+
+        for (uint16_t tap = 0; tap < axis.taps; tap++) {
+            double overlap = std::min<double>(end, first + tap + 1) - std::max<double>(begin, first + tap);
+
+            if (overlap > 0.0) {
+                axis.weights[index * axis.taps + tap] = static_cast<float>(overlap / scale);
+            }
+        }
+    }
+
+    return axis;
+}
+
+void cynes::ObservationPipeline::capture(const NES& nes, uint8_t* buffer) const {
+    size_t width = _crop_width;
+    size_t row_size = width * _channels;
+
+    if (nes.get_frame_format() == FrameFormat::PALETTE) {
+        const uint8_t* indices = nes.get_index_buffer();
+        const uint8_t* emphasis = nes.get_emphasis_buffer();
+
+        for (uint16_t y = _config.crop_top; y < _config.crop_top + _crop_height; y++) {
+            const uint8_t* row = indices + (y << 8) + _config.crop_left;
+            uint8_t row_emphasis = emphasis[y] & 0x07;
+
+            if (_config.grayscale) {
+                const uint8_t* colors = _gray_colors[row_emphasis];
+
+                for (size_t x = 0; x < width; x++) {
+                    buffer[x] = colors[row[x] & 0x3F];
+                }
+            } else {
+                for (size_t x = 0; x < width; x++) {
+                    std::memcpy(buffer + x * 3, get_palette_color(row[x], row_emphasis), 3);
+                }
+            }
+
+            buffer += row_size;
+        }
+    } else {
+        const uint8_t* frame_buffer = nes.get_frame_buffer();
+
+        for (uint16_t y = _config.crop_top; y < _config.crop_top + _crop_height; y++) {
+            const uint8_t* row = frame_buffer + ((y << 8) + _config.crop_left) * 3;
+
+            if (_config.grayscale) {
+                for (size_t x = 0; x < width; x++) {
+                    buffer[x] = get_luma(row + x * 3);
+                }
+            } else {
+                std::memcpy(buffer, row, row_size);
+            }
+
+            buffer += row_size;
+        }
+    }
+}
+
+void cynes::ObservationPipeline::resize(const uint8_t* source, uint8_t* destination) {
+    size_t row_size = static_cast<size_t>(_crop_width) * _channels;
+    size_t plane_size = static_cast<size_t>(_config.width) * _config.height;
+
+    for (uint16_t y = 0; y < _config.height; y++) {
+        float* row = _resize_buffer.get() + y * row_size;
+
+        std::fill_n(row, row_size, 0.0f);
+
+        for (uint16_t tap = 0; tap < _resize_y.taps; tap++) {
+            float weight = _resize_y.weights[y * _resize_y.taps + tap];
+            const uint8_t* source_row = source + (_resize_y.offsets[y] + tap) * row_size;
+
+            if (weight == 0.0f) {
+                continue;
+            }
+
+            for (size_t k = 0; k < row_size; k++) {
+                row[k] += weight * source_row[k];
+            }
+        }
+    }
+
+    for (uint16_t y = 0; y < _config.height; y++) {
+        const float* row = _resize_buffer.get() + y * row_size;
+
+        for (uint16_t x = 0; x < _config.width; x++) {
+            const float* weights = _resize_x.weights.data() + x * _resize_x.taps;
+            const float* pixels = row + _resize_x.offsets[x] * _channels;
+
+            for (uint8_t channel = 0; channel < _channels; channel++) {
+                float value = 0.5f;
+
+                for (uint16_t tap = 0; tap < _resize_x.taps; tap++) {
+                    value += weights[tap] * pixels[tap * _channels + channel];
+                }
+
+                destination[channel * plane_size + y * _config.width + x] = static_cast<uint8_t>(std::min(value, 255.0f));
+            }
+        }
+    }
+}
+
+void cynes::ObservationPipeline::write(uint8_t* observation) const {
+    size_t pixels = static_cast<size_t>(_config.width) * _config.height;
+    size_t frame_size = get_frame_size();
+
+    for (uint8_t stack = 0; stack < _config.stack; stack++) {
+        const uint8_t* frame = _frames.get() + ((_frame_head + 1 + stack) % _config.stack) * frame_size;
+
+        if (_config.layout == ObservationLayout::CHW) {
+            std::memcpy(observation + stack * frame_size, frame, frame_size);
+            continue;
+        }
+
+        size_t stride = static_cast<size_t>(_config.stack) * _channels;
+
+        for (uint8_t channel = 0; channel < _channels; channel++) {
+            const uint8_t* plane = frame + channel * pixels;
+            uint8_t* output = observation + stack * _channels + channel;
+
+            for (size_t pixel = 0; pixel < pixels; pixel++) {
+                output[pixel * stride] = plane[pixel];
+            }
+        }
+    }
+}
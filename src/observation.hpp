@@ -0,0 +1,146 @@
+#ifndef __CYNES_OBSERVATION__
+#define __CYNES_OBSERVATION__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "nes.hpp"
+
+namespace cynes {
+/// Memory layout of the stacked observations.
+enum class ObservationLayout : uint8_t {
+    /// Height, width, then the channels of every stacked frame.
+    HWC,
+    /// The channels of every stacked frame, then height and width.
+    CHW
+};
+
+/// Settings of an observation pipeline.
+struct ObservationConfig {
+public:
+    uint16_t width = 84;
+    uint16_t height = 84;
+
+    uint16_t crop_top = 0;
+    uint16_t crop_bottom = 0;
+    uint16_t crop_left = 0;
+    uint16_t crop_right = 0;
+
+    uint8_t stack = 4;
+
+    bool grayscale = true;
+    bool max_pool = true;
+
+    ObservationLayout layout = ObservationLayout::HWC;
+};
+
+/// Preprocessing pipeline turning the frames of an emulator into stacked observations.
+/// Each step, the last frame is cropped, optionally converted to grayscale and
+/// max-pooled with the frame preceding it, and resized using area interpolation. The
+/// processed frames are kept in a ring buffer, from which the stack of the last frames
+/// is written, oldest first.
+class ObservationPipeline {
+public:
+    /// Initialize the pipeline.
+    /// @param config Pipeline settings.
+    ObservationPipeline(const ObservationConfig& config);
+
+    /// Initialize the pipeline as a copy of another pipeline, including its stacked
+    /// frames.
+    /// @param other Pipeline to copy.
+    ObservationPipeline(const ObservationPipeline& other);
+
+    /// Default destructor.
+    ~ObservationPipeline() = default;
+
+    ObservationPipeline& operator=(const ObservationPipeline&) = delete;
+
+public:
+    /// Step the emulator and write the resulting observation.
+    /// @note With max pooling, the emulator is stepped in two parts so that the frame
+    /// before last can be captured.
+    /// @param nes Emulator to step.
+    /// @param controllers Controllers states (see `NES::step`).
+    /// @param frames Number of frame of the step.
+    /// @param observation Output observation buffer, of `ObservationPipeline::size`
+    /// bytes.
+    /// @return True if the CPU is frozen, false otherwise.
+    bool step(NES& nes, uint16_t controllers, unsigned int frames, uint8_t* observation);
+
+    /// Capture the frame before last of a step, max-pooled with the last frame by the
+    /// next call to `ObservationPipeline::update`.
+    /// @note Used to drive the pipeline while stepping the emulator separately, it has
+    /// no effect if max pooling is disabled.
+    /// @param nes Emulator whose current frame is captured.
+    void capture_previous(const NES& nes);
+
+    /// Process the last frame of a step and write the resulting observation.
+    /// @param nes Emulator whose current frame is processed.
+    /// @param observation Output observation buffer, of `ObservationPipeline::size`
+    /// bytes.
+    void update(const NES& nes, uint8_t* observation);
+
+    /// Clear the stacked frames.
+    /// @note The first frame processed after a call to this function fills the whole
+    /// stack, it should be called whenever the emulator is reset or loaded.
+    void clear();
+
+    /// Get the size of an observation.
+    /// @return The size of an observation in bytes.
+    size_t size() const;
+
+    /// Get the pipeline settings.
+    /// @return The settings.
+    inline const ObservationConfig& get_config() const {
+        return _config;
+    }
+
+private:
+    ObservationConfig _config;
+
+    uint16_t _crop_width;
+    uint16_t _crop_height;
+    uint8_t _channels;
+
+    uint8_t _gray_colors[0x8][0x40];
+
+    size_t get_capture_size() const;
+    size_t get_frame_size() const;
+
+    std::unique_ptr<uint8_t[]> _capture_buffers;
+    bool _previous_captured;
+
+private:
+    /// Source pixels contributing to each output pixel along one axis. Every output
+    /// pixel has the same number of taps, unused taps have a null weight.
+    struct ResizeAxis {
+    public:
+        uint16_t taps = 0;
+
+        std::vector<uint16_t> offsets;
+        std::vector<float> weights;
+    };
+
+    ResizeAxis _resize_x;
+    ResizeAxis _resize_y;
+
+    std::unique_ptr<float[]> _resize_buffer;
+
+    static ResizeAxis get_resize_axis(uint16_t source, uint16_t destination);
+
+    void capture(const NES& nes, uint8_t* buffer) const;
+    void resize(const uint8_t* source, uint8_t* destination);
+
+private:
+    std::unique_ptr<uint8_t[]> _frames;
+
+    uint8_t _frame_head;
+    bool _frames_empty;
+
+    void write(uint8_t* observation) const;
+};
+}
+
+#endif
@@ -0,0 +1,163 @@
+#include "pool.hpp"
+
+
+cynes::ThreadPool::ThreadPool(size_t threads)
+    : _workers{}
+    , _ranges{}
+    , _task{nullptr}
+    , _generation{0}
+    , _running{0}
+    , _stopping{false}
+{
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+
+    if (threads == 0) {
+        threads = 1;
+    }
+
+    _ranges.reset(new Range[threads]);
+
+    for (size_t worker = 1; worker < threads; worker++) {
+        _workers.emplace_back(&ThreadPool::work, this, worker);
+    }
+}
+
+cynes::ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        _stopping = true;
+    }
+
+    _condition_start.notify_all();
+
+    for (std::thread& worker : _workers) {
+        worker.join();
+    }
+}
+
+size_t cynes::ThreadPool::size() const {
+    return _workers.size() + 1;
+}
+
+void cynes::ThreadPool::run(size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0) {
+        return;
+    }
+
+    size_t threads = size();
+
+    for (size_t worker = 0; worker < threads; worker++) {
+        uint64_t begin = count * worker / threads;
+        uint64_t end = count * (worker + 1) / threads;
+
+        _ranges[worker].bounds.store(begin << 32 | end, std::memory_order_relaxed);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+
+        _task = &task;
+        _running = _workers.size();
+        _generation++;
+    }
+
+    _condition_start.notify_all();
+
+    drain(0);
+
+    std::unique_lock<std::mutex> lock{_mutex};
+    _condition_done.wait(lock, [this] { return _running == 0; });
+
+    _task = nullptr;
+}
+
+void cynes::ThreadPool::work(size_t worker) {
+    uint64_t generation = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock{_mutex};
+
+            _condition_start.wait(lock, [this, generation] {
+                return _stopping || _generation != generation;
+            });
+
+            if (_stopping) {
+                return;
+            }
+
+            generation = _generation;
+        }
+
+        drain(worker);
+
+        bool done = false;
+
+        {
+            std::lock_guard<std::mutex> lock{_mutex};
+            done = --_running == 0;
+        }
+
+        if (done) {
+            _condition_done.notify_one();
+        }
+    }
+}
+
+void cynes::ThreadPool::drain(size_t worker) {
+    size_t index;
+
+    while (pop_front(worker, index)) {
+        (*_task)(index);
+    }
+
+    size_t threads = size();
+
+    for (size_t offset = 1; offset < threads; offset++) {
+        size_t victim = (worker + offset) % threads;
+
+        while (pop_back(victim, index)) {
+            (*_task)(index);
+        }
+    }
+}
+
+bool cynes::ThreadPool::pop_front(size_t worker, size_t& index) {
+    std::atomic<uint64_t>& bounds = _ranges[worker].bounds;
+    uint64_t value = bounds.load(std::memory_order_relaxed);
+
+    while (true) {
+        uint64_t begin = value >> 32;
+        uint64_t end = value & 0xFFFFFFFF;
+
+        if (begin >= end) {
+            return false;
+        }
+
+        if (bounds.compare_exchange_weak(value, (begin + 1) << 32 | end, std::memory_order_relaxed)) {
+            index = begin;
+            return true;
+        }
+    }
+}
+
+bool cynes::ThreadPool::pop_back(size_t worker, size_t& index) {
+    std::atomic<uint64_t>& bounds = _ranges[worker].bounds;
+    uint64_t value = bounds.load(std::memory_order_relaxed);
+
+    while (true) {
+        uint64_t begin = value >> 32;
+        uint64_t end = value & 0xFFFFFFFF;
+
+        if (begin >= end) {
+            return false;
+        }
+
+        if (bounds.compare_exchange_weak(value, begin << 32 | (end - 1), std::memory_order_relaxed)) {
+            index = end - 1;
+            return true;
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef __CYNES_POOL__
+#define __CYNES_POOL__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cynes {
+/// Persistent worker pool running batches of independent tasks.
+/// Each batch is split into one contiguous range per worker. A worker consumes its own
+/// range from the front and, once it is exhausted, steals tasks from the back of the
+/// other ranges, so that uneven task durations do not leave cores idle.
+class ThreadPool {
+public:
+    /// Initialize the pool and start the workers.
+    /// @param threads Number of threads, including the calling thread. If zero, the
+    /// number of hardware threads is used.
+    ThreadPool(size_t threads = 0);
+
+    /// Stop and join the workers.
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+public:
+    /// Get the number of threads used to run a batch.
+    /// @return The number of threads, including the calling thread.
+    size_t size() const;
+
+    /// Run a batch of tasks and wait for all of them to complete.
+    /// @note The calling thread takes part in the batch. Tasks must not throw.
+    /// @param count Number of tasks of the batch.
+    /// @param task Task to run, called once for every index in `[0, count)`.
+    void run(size_t count, const std::function<void(size_t)>& task);
+
+private:
+    struct alignas(64) Range {
+        std::atomic<uint64_t> bounds{0};
+    };
+
+private:
+    std::vector<std::thread> _workers;
+    std::unique_ptr<Range[]> _ranges;
+
+    std::mutex _mutex;
+    std::condition_variable _condition_start;
+    std::condition_variable _condition_done;
+
+    const std::function<void(size_t)>* _task;
+
+    uint64_t _generation;
+    size_t _running;
+    bool _stopping;
+
+private:
+    void work(size_t worker);
+    void drain(size_t worker);
+
+    bool pop_front(size_t worker, size_t& index);
+    bool pop_back(size_t worker, size_t& index);
+};
+}
+
+#endif
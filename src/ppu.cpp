@@ -2,7 +2,9 @@
 #include "cpu.hpp"
 #include "nes.hpp"
 #include "mapper.hpp"
+#include "tiles.hpp"
 
+#include <algorithm>
 #include <cstring>
 
 
@@ -106,11 +108,39 @@ constexpr uint8_t PALETTE_COLORS[0x8][0x40][0x3] = {
 };
 
 
-cynes::PPU::PPU(NES& nes)
+const uint8_t* cynes::get_palette_color(uint8_t index, uint8_t emphasis) {
+    return PALETTE_COLORS[emphasis & 0x07][index & 0x3F];
+}
+
+void cynes::convert_palette_indices(
+    const uint8_t* indices,
+    const uint8_t* emphasis,
+    uint8_t* frame_buffer
+) {
+    for (uint16_t y = 0; y < 240; y++) {
+        const uint8_t (*colors)[0x3] = PALETTE_COLORS[emphasis[y] & 0x07];
+
+        for (uint16_t x = 0; x < 256; x++) {
+            memcpy(frame_buffer, colors[*indices++ & 0x3F], 3);
+            frame_buffer += 3;
+        }
+    }
+}
+
+
+template<class MapperType>
+cynes::PPU<MapperType>::PPU(NESCore<MapperType>& nes)
     : _nes{nes}
     , _frame_buffer{new uint8_t[0x2D000]}
+    , _index_buffer{new uint8_t[0xF000]{}}
+    , _emphasis_buffer{new uint8_t[0xF0]{}}
+    , _frame_output{_frame_buffer.get()}
+    , _index_output{_index_buffer.get()}
+    , _frame_format{FrameFormat::RGB}
+    , _render_skip{false}
     , _current_x{0x0000}
     , _current_y{0x0000}
+    , _frame_ready{false}
     , _rendering_enabled{false}
     , _rendering_enabled_delayed{false}
     , _prevent_vertical_blank{false}
@@ -140,6 +170,7 @@ cynes::PPU::PPU(NES& nes)
     , _delay_data_write_counter{0x00}
     , _buffer_data{0x00}
     , _background_data{}
+    , _background_row{0x0000}
     , _background_shifter{}
     , _foreground_data{}
     , _foreground_shifter{}
@@ -157,7 +188,7 @@ cynes::PPU::PPU(NES& nes)
     , _foreground_evaluation_step{SpriteEvaluationStep::LOAD_SECONDARY_OAM}
 {
     std::memset(_clock_decays, 0x00, 0x3);
-    std::memset(_background_data, 0x00, 0x4);
+    std::memset(_background_data, 0x00, 0x2);
     std::memset(_background_shifter, 0x0000, 0x8);
     std::memset(_foreground_data, 0x00, 0x20);
     std::memset(_foreground_shifter, 0x00, 0x10);
@@ -165,7 +196,79 @@ cynes::PPU::PPU(NES& nes)
     std::memset(_foreground_positions, 0x00, 0x8);
 }
 
-void cynes::PPU::power() {
+template<class MapperType>
+cynes::PPU<MapperType>::PPU(NESCore<MapperType>& nes, const PPU& other)
+    : _nes{nes}
+    , _frame_buffer{new uint8_t[0x2D000]}
+    , _index_buffer{new uint8_t[0xF000]}
+    , _emphasis_buffer{new uint8_t[0xF0]}
+    , _frame_output{_frame_buffer.get()}
+    , _index_output{_index_buffer.get()}
+    , _frame_format{other._frame_format}
+    , _render_skip{false}
+    , _current_x{other._current_x}
+    , _current_y{other._current_y}
+    , _frame_ready{other._frame_ready}
+    , _rendering_enabled{other._rendering_enabled}
+    , _rendering_enabled_delayed{other._rendering_enabled_delayed}
+    , _prevent_vertical_blank{other._prevent_vertical_blank}
+    , _control_increment_mode{other._control_increment_mode}
+    , _control_foreground_table{other._control_foreground_table}
+    , _control_background_table{other._control_background_table}
+    , _control_foreground_large{other._control_foreground_large}
+    , _control_interrupt_on_vertical_blank{other._control_interrupt_on_vertical_blank}
+    , _mask_grayscale_mode{other._mask_grayscale_mode}
+    , _mask_render_background_left{other._mask_render_background_left}
+    , _mask_render_foreground_left{other._mask_render_foreground_left}
+    , _mask_render_background{other._mask_render_background}
+    , _mask_render_foreground{other._mask_render_foreground}
+    , _mask_color_emphasize{other._mask_color_emphasize}
+    , _status_sprite_overflow{other._status_sprite_overflow}
+    , _status_sprite_zero_hit{other._status_sprite_zero_hit}
+    , _status_vertical_blank{other._status_vertical_blank}
+    , _clock_decays{}
+    , _register_decay{other._register_decay}
+    , _latch_cycle{other._latch_cycle}
+    , _latch_address{other._latch_address}
+    , _register_t{other._register_t}
+    , _register_v{other._register_v}
+    , _delayed_register_v{other._delayed_register_v}
+    , _scroll_x{other._scroll_x}
+    , _delay_data_read_counter{other._delay_data_read_counter}
+    , _delay_data_write_counter{other._delay_data_write_counter}
+    , _buffer_data{other._buffer_data}
+    , _background_data{}
+    , _background_row{other._background_row}
+    , _background_shifter{}
+    , _foreground_data{}
+    , _foreground_shifter{}
+    , _foreground_attributes{}
+    , _foreground_positions{}
+    , _foreground_data_pointer{other._foreground_data_pointer}
+    , _foreground_sprite_count{other._foreground_sprite_count}
+    , _foreground_sprite_count_next{other._foreground_sprite_count_next}
+    , _foreground_sprite_pointer{other._foreground_sprite_pointer}
+    , _foreground_read_delay_counter{other._foreground_read_delay_counter}
+    , _foreground_sprite_address{other._foreground_sprite_address}
+    , _foreground_sprite_zero_line{other._foreground_sprite_zero_line}
+    , _foreground_sprite_zero_should{other._foreground_sprite_zero_should}
+    , _foreground_sprite_zero_hit{other._foreground_sprite_zero_hit}
+    , _foreground_evaluation_step{other._foreground_evaluation_step}
+{
+    std::memcpy(_frame_buffer.get(), other._frame_buffer.get(), 0x2D000);
+    std::memcpy(_index_buffer.get(), other._index_buffer.get(), 0xF000);
+    std::memcpy(_emphasis_buffer.get(), other._emphasis_buffer.get(), 0xF0);
+    std::memcpy(_clock_decays, other._clock_decays, 0x3);
+    std::memcpy(_background_data, other._background_data, 0x2);
+    std::memcpy(_background_shifter, other._background_shifter, 0x8);
+    std::memcpy(_foreground_data, other._foreground_data, 0x20);
+    std::memcpy(_foreground_shifter, other._foreground_shifter, 0x10);
+    std::memcpy(_foreground_attributes, other._foreground_attributes, 0x8);
+    std::memcpy(_foreground_positions, other._foreground_positions, 0x8);
+}
+
+template<class MapperType>
+void cynes::PPU<MapperType>::power() {
     _current_y = 0xFF00;
     _current_x = 0xFF00;
 
@@ -205,7 +308,8 @@ void cynes::PPU::power() {
     _buffer_data = 0x00;
 }
 
-void cynes::PPU::reset() {
+template<class MapperType>
+void cynes::PPU<MapperType>::reset() {
     _current_y = 0xFF00;
     _current_x = 0xFF00;
 
@@ -239,7 +343,8 @@ void cynes::PPU::reset() {
     _buffer_data = 0x00;
 }
 
-void cynes::PPU::tick() {
+template<class MapperType>
+void cynes::PPU<MapperType>::tick() {
     if (_current_x > 339) {
         _current_x = 0;
 
@@ -295,7 +400,14 @@ void cynes::PPU::tick() {
             }
 
             if (_current_x > 0 && _current_x < 257 && _current_y < 240) {
-                memcpy(_frame_buffer.get() + ((_current_y << 8) + _current_x - 1) * 3, PALETTE_COLORS[_mask_color_emphasize][_nes.read_ppu(0x3F00 | blend_colors())], 3);
+                if (_render_skip) {
+                    update_sprite_zero_hit();
+                } else if (_frame_format == FrameFormat::PALETTE) {
+                    _index_output[(_current_y << 8) + _current_x - 1] = _nes.read_ppu(0x3F00 | blend_colors());
+                    _emphasis_buffer[_current_y] = _mask_color_emphasize;
+                } else {
+                    memcpy(_frame_output + ((_current_y << 8) + _current_x - 1) * 3, PALETTE_COLORS[_mask_color_emphasize][_nes.read_ppu(0x3F00 | blend_colors())], 3);
+                }
             }
         } else if (_current_y == 240 && _current_x == 1) {
             _nes.read_ppu(_register_v);
@@ -327,7 +439,7 @@ void cynes::PPU::tick() {
             }
 
             if (_rendering_enabled && (_current_x == 337 || _current_x == 339)) {
-                _nes.read_ppu(0x2000 | (_register_v & 0x0FFF));
+                _nes.fetch_ppu(0x2000 | (_register_v & 0x0FFF));
 
                 if (_current_x == 339 && _latch_cycle) {
                     _current_x = 340;
@@ -379,10 +491,167 @@ void cynes::PPU::tick() {
         _delay_data_read_counter--;
     }
 
-    _nes.get_mapper().tick();
+    _nes.advance_cycle();
+}
+
+template<class MapperType>
+void cynes::PPU<MapperType>::render_scanline() {
+    uint8_t background_pixels[0x100];
+    uint8_t foreground_pixels[0x100];
+
+    if (_rendering_enabled) {
+        for (uint16_t x = 0; x < 0x100; x += 8) {
+            update_background_shifters();
+            reload_background_shifters();
+            fetch_background_name();
+
+            uint32_t pattern = _background_shifter[0] << (_scroll_x << 1);
+            uint32_t palette = _background_shifter[1] << (_scroll_x << 1);
+
+            for (uint8_t k = 0; k < 8; k++) {
+                background_pixels[x + k] = (palette >> 28 & 0x0C) | (pattern >> 30);
+
+                pattern <<= 2;
+                palette <<= 2;
+            }
+
+            fetch_background_attribute();
+            fetch_background_pattern_low();
+            fetch_background_pattern_high();
+            increment_scroll_x();
+
+            _background_shifter[0] <<= 14;
+            _background_shifter[1] <<= 14;
+        }
+
+        increment_scroll_y();
+    }
+
+    // Sprites are composed from their state at the start of the scanline, lower indices
+    // having the priority. Each entry holds the pixel, the palette, the priority and
+    // whether or not it comes from the sprite zero.
+    if (_mask_render_foreground) {
+        std::memset(foreground_pixels, 0x00, 0x100);
+
+        for (uint8_t sprite = _foreground_sprite_count_next; sprite-- > 0;) {
+            uint16_t position = _foreground_positions[sprite];
+            uint16_t shifter = _foreground_shifter[sprite];
+
+            uint8_t attributes = (_foreground_attributes[sprite] & 0x03) << 2;
+            attributes |= (_foreground_attributes[sprite] & 0x20) ? 0x00 : 0x10;
+            attributes |= sprite == 0 ? 0x20 : 0x00;
+
+            for (uint16_t x = position; x < position + 8 && x < 0x100; x++) {
+                if (shifter & 0xC000) {
+                    foreground_pixels[x] = attributes | shifter >> 14;
+                }
+
+                shifter <<= 2;
+            }
+
+            if (position < 0xFF) {
+                uint8_t shifts = 0xFF - position;
+
+                _foreground_shifter[sprite] = shifts < 8 ? _foreground_shifter[sprite] << (shifts << 1) : 0x0000;
+                _foreground_positions[sprite] = 0x00;
+            } else {
+                _foreground_positions[sprite] -= 0xFF;
+            }
+        }
+
+        // The sprite zero hit is never reported on the last dot.
+        foreground_pixels[0xFF] &= 0x1F;
+    }
+
+    for (_current_x = 1; _current_x < 65; _current_x += 2) {
+        clear_foreground_data();
+    }
+
+    for (_current_x = 66; _current_x < 257; _current_x += 2) {
+        fetch_foreground_data();
+    }
+
+    bool background_color = !_rendering_enabled && (_register_v & 0x3FFF) >= 0x3F00;
+    bool foreground_hit = false;
+
+    uint8_t colors[0x20];
+
+    for (uint8_t k = 0x00; k < 0x20; k++) {
+        colors[k] = _nes.read_ppu(0x3F00 | k);
+    }
+
+    for (uint16_t x = 0; x < 0x100; x++) {
+        uint8_t final_pixel = _register_v & 0x1F;
+
+        if (!background_color) {
+            uint8_t background_pixel = 0x00;
+            uint8_t foreground_pixel = 0x00;
+
+            if (_mask_render_background && (x >= 8 || _mask_render_background_left)) {
+                background_pixel = background_pixels[x];
+            }
+
+            if (_mask_render_foreground && (x >= 8 || _mask_render_foreground_left)) {
+                foreground_pixel = foreground_pixels[x];
+                foreground_hit = foreground_pixel & 0x20;
+            }
+
+            if (!(background_pixel & 0x03)) {
+                final_pixel = foreground_pixel & 0x03 ? (foreground_pixel & 0x0F) + 0x10 : 0x00;
+            } else if (!(foreground_pixel & 0x03)) {
+                final_pixel = background_pixel;
+            } else {
+                final_pixel = foreground_pixel & 0x10 ? (foreground_pixel & 0x0F) + 0x10 : background_pixel;
+
+                if (foreground_hit && _foreground_sprite_zero_line) {
+                    _status_sprite_zero_hit = true;
+                }
+            }
+
+            if (_mask_grayscale_mode) {
+                final_pixel &= 0x30;
+            }
+        }
+
+        if (_render_skip) {
+            continue;
+        }
+
+        if (_frame_format == FrameFormat::PALETTE) {
+            _index_output[(_current_y << 8) + x] = colors[final_pixel];
+        } else {
+            memcpy(_frame_output + ((_current_y << 8) + x) * 3, PALETTE_COLORS[_mask_color_emphasize][colors[final_pixel]], 3);
+        }
+    }
+
+    if (_frame_format == FrameFormat::PALETTE && !_render_skip) {
+        _emphasis_buffer[_current_y] = _mask_color_emphasize;
+    }
+
+    if (_mask_render_foreground) {
+        _foreground_sprite_zero_hit = foreground_hit;
+    }
+
+    _current_x = 257;
+
+    reset_scroll_x();
+
+    for (; _current_x < 321; _current_x++) {
+        load_foreground_shifter();
+    }
+
+    for (; _current_x < 337; _current_x++) {
+        load_background_shifters();
+    }
+
+    _current_x = 340;
+
+    _delay_data_read_counter = 0x00;
+    _nes.advance_cycle(340);
 }
 
-void cynes::PPU::write(uint8_t address, uint8_t value) {
+template<class MapperType>
+void cynes::PPU<MapperType>::write(uint8_t address, uint8_t value) {
     memset(_clock_decays, DECAY_PERIOD, 3);
 
     _register_decay = value;
@@ -459,7 +728,7 @@ void cynes::PPU::write(uint8_t address, uint8_t value) {
     case Register::PPU_ADDR: {
         if (!_latch_address) {
             _register_t &= 0x00FF;
-            _register_t |= value << 8;
+            _register_t |= (value & 0x3F) << 8;
         } else {
             _register_t &= 0xFF00;
             _register_t |= value;
@@ -501,7 +770,8 @@ void cynes::PPU::write(uint8_t address, uint8_t value) {
     }
 }
 
-uint8_t cynes::PPU::read(uint8_t address) {
+template<class MapperType>
+uint8_t cynes::PPU<MapperType>::read(uint8_t address) {
     switch (static_cast<Register>(address)) {
     case Register::PPU_STATUS: {
         memset(_clock_decays, DECAY_PERIOD, 2);
@@ -571,18 +841,97 @@ uint8_t cynes::PPU::read(uint8_t address) {
     return _register_decay;
 }
 
-const uint8_t* cynes::PPU::get_frame_buffer() const {
+template<class MapperType>
+const uint8_t* cynes::PPU<MapperType>::get_frame_buffer() const {
     return _frame_buffer.get();
 }
 
-bool cynes::PPU::is_frame_ready() {
+template<class MapperType>
+const uint8_t* cynes::PPU<MapperType>::get_index_buffer() const {
+    return _index_buffer.get();
+}
+
+template<class MapperType>
+const uint8_t* cynes::PPU<MapperType>::get_emphasis_buffer() const {
+    return _emphasis_buffer.get();
+}
+
+template<class MapperType>
+void cynes::PPU<MapperType>::set_frame_format(FrameFormat format) {
+    _frame_format = format;
+}
+
+template<class MapperType>
+cynes::FrameFormat cynes::PPU<MapperType>::get_frame_format() const {
+    return _frame_format;
+}
+
+template<class MapperType>
+void cynes::PPU<MapperType>::convert_frame_buffer() {
+    convert_palette_indices(_index_buffer.get(), _emphasis_buffer.get(), _frame_buffer.get());
+}
+
+template<class MapperType>
+void cynes::PPU<MapperType>::set_render_skip(bool skip) {
+    _render_skip = skip;
+}
+
+template<class MapperType>
+void cynes::PPU<MapperType>::set_frame_target(uint8_t* target) {
+    if (target == nullptr) {
+        _frame_output = _frame_buffer.get();
+        _index_output = _index_buffer.get();
+        return;
+    }
+
+    if (_current_y < 240) {
+        size_t pixels = (_current_y << 8) + std::min<uint16_t>(_current_x, 256);
+
+        if (_frame_format == FrameFormat::PALETTE) {
+            std::memcpy(target, _index_output, pixels);
+        } else {
+            std::memcpy(target, _frame_output, pixels * 3);
+        }
+    }
+
+    _frame_output = target;
+    _index_output = target;
+}
+
+template<class MapperType>
+bool cynes::PPU<MapperType>::is_frame_ready() {
     bool frame_ready = _frame_ready;
     _frame_ready = false;
 
     return frame_ready;
 }
 
-void cynes::PPU::increment_scroll_x() {
+template<class MapperType>
+uint32_t cynes::PPU<MapperType>::get_event_distance() const {
+    constexpr uint32_t FRAME_DOTS = 262 * 341;
+    constexpr uint32_t EVENTS[3] = {0, 241 * 341 + 1, 261 * 341 + 1};
+
+    uint32_t position = FRAME_DOTS - 1;
+
+    if (_current_x < 341 && _current_y < 262) {
+        position = _current_y * 341 + _current_x;
+    }
+
+    uint32_t distance = FRAME_DOTS;
+
+    for (uint32_t event : EVENTS) {
+        uint32_t event_distance = (event + FRAME_DOTS - position) % FRAME_DOTS;
+
+        if (event_distance > 0 && event_distance < distance) {
+            distance = event_distance;
+        }
+    }
+
+    return distance - 1;
+}
+
+template<class MapperType>
+void cynes::PPU<MapperType>::increment_scroll_x() {
     if (_mask_render_background || _mask_render_foreground) {
         if ((_register_v & 0x001F) == 0x1F) {
             _register_v &= 0xFFE0;
@@ -593,7 +942,8 @@ void cynes::PPU::increment_scroll_x() {
     }
 }
 
-void cynes::PPU::increment_scroll_y() {
+template<class MapperType>
+void cynes::PPU<MapperType>::increment_scroll_y() {
     if (_mask_render_background || _mask_render_foreground) {
         if ((_register_v & 0x7000) != 0x7000) {
             _register_v += 0x1000;
@@ -617,14 +967,16 @@ void cynes::PPU::increment_scroll_y() {
     }
 }
 
-void cynes::PPU::reset_scroll_x() {
+template<class MapperType>
+void cynes::PPU<MapperType>::reset_scroll_x() {
     if (_mask_render_background || _mask_render_foreground) {
         _register_v &= 0xFBE0;
         _register_v |= _register_t & 0x041F;
     }
 }
 
-void cynes::PPU::reset_scroll_y() {
+template<class MapperType>
+void cynes::PPU<MapperType>::reset_scroll_y() {
     if (_mask_render_background || _mask_render_foreground) {
         _register_v &= 0x841F;
         _register_v |= _register_t & 0x7BE0;
@@ -632,93 +984,84 @@ void cynes::PPU::reset_scroll_y() {
 }
 
 
-void cynes::PPU::load_background_shifters() {
+template<class MapperType>
+void cynes::PPU<MapperType>::load_background_shifters() {
     update_background_shifters();
 
     if (_rendering_enabled) {
         switch (_current_x & 0x07) {
-        case 0x1: {
-            _background_shifter[0] = (_background_shifter[0] & 0xFF00) | _background_data[2];
-            _background_shifter[1] = (_background_shifter[1] & 0xFF00) | _background_data[3];
-
-            if (_background_data[1] & 0x01) {
-                _background_shifter[2] = (_background_shifter[2] & 0xFF00) | 0xFF;
-            } else {
-                _background_shifter[2] = (_background_shifter[2] & 0xFF00);
-            }
-
-            if (_background_data[1] & 0x02) {
-                _background_shifter[3] = (_background_shifter[3] & 0xFF00) | 0xFF;
-            } else {
-                _background_shifter[3] = (_background_shifter[3] & 0xFF00);
-            }
-
-            uint16_t address = 0x2000;
-            address |= _register_v & 0x0FFF;
-
-            _background_data[0] = _nes.read_ppu(address);
-
-            break;
+        case 0x1: reload_background_shifters(); fetch_background_name(); break;
+        case 0x3: fetch_background_attribute(); break;
+        case 0x5: fetch_background_pattern_low(); break;
+        case 0x7: fetch_background_pattern_high(); break;
+        case 0x0: increment_scroll_x(); break;
         }
+    }
+}
 
-        case 0x3: {
-            uint16_t address = 0x23C0;
-            address |= _register_v & 0x0C00;
-            address |= (_register_v >> 4) & 0x38;
-            address |= (_register_v >> 2) & 0x07;
-
-            _background_data[1] = _nes.read_ppu(address);
+template<class MapperType>
+void cynes::PPU<MapperType>::reload_background_shifters() {
+    _background_shifter[0] = (_background_shifter[0] & 0xFFFF0000) | _background_row;
+    _background_shifter[1] = (_background_shifter[1] & 0xFFFF0000) | _background_data[1] * 0x5555;
+}
 
-            if (_register_v & 0x0040) {
-                _background_data[1] >>= 4;
-            }
+template<class MapperType>
+void cynes::PPU<MapperType>::fetch_background_name() {
+    uint16_t address = 0x2000;
+    address |= _register_v & 0x0FFF;
 
-            if (_register_v & 0x0002) {
-                _background_data[1] >>= 2;
-            }
+    _background_data[0] = _nes.fetch_ppu(address);
+}
 
-            _background_data[1] &= 0x03;
+template<class MapperType>
+void cynes::PPU<MapperType>::fetch_background_attribute() {
+    uint16_t address = 0x23C0;
+    address |= _register_v & 0x0C00;
+    address |= (_register_v >> 4) & 0x38;
+    address |= (_register_v >> 2) & 0x07;
 
-            break;
-        }
+    _background_data[1] = _nes.fetch_ppu(address);
 
-        case 0x5: {
-            uint16_t address = _control_background_table << 12;
-            address |= _background_data[0] << 4;
-            address |= _register_v >> 12;
-
-            _background_data[2] = _nes.read_ppu(address);
+    if (_register_v & 0x0040) {
+        _background_data[1] >>= 4;
+    }
 
-            break;
-        }
+    if (_register_v & 0x0002) {
+        _background_data[1] >>= 2;
+    }
 
-        case 0x7: {
-            uint16_t address = _control_background_table << 12;
-            address |= _background_data[0] << 4;
-            address |= _register_v >> 12;
-            address += 0x8;
+    _background_data[1] &= 0x03;
+}
 
-            _background_data[3] = _nes.read_ppu(address);
+template<class MapperType>
+void cynes::PPU<MapperType>::fetch_background_pattern_low() {
+    uint16_t address = _control_background_table << 12;
+    address |= _background_data[0] << 4;
+    address |= _register_v >> 12;
 
-            break;
+    _background_row = (_background_row & 0xAAAA) | TileCache::spread(_nes.fetch_ppu(address));
+}
 
-        }
+template<class MapperType>
+void cynes::PPU<MapperType>::fetch_background_pattern_high() {
+    uint16_t address = _control_background_table << 12;
+    address |= _background_data[0] << 4;
+    address |= _register_v >> 12;
+    address += 0x8;
 
-        case 0x0: increment_scroll_x(); break;
-        }
-    }
+    _background_row = _nes.fetch_tile_row(address, _background_row, false);
 }
 
-void cynes::PPU::update_background_shifters() {
+template<class MapperType>
+void cynes::PPU<MapperType>::update_background_shifters() {
     if (_mask_render_background || _mask_render_foreground) {
-        _background_shifter[0] <<= 1;
-        _background_shifter[1] <<= 1;
-        _background_shifter[2] <<= 1;
-        _background_shifter[3] <<= 1;
+        _background_shifter[0] <<= 2;
+        _background_shifter[1] <<= 2;
     }
 }
 
-void cynes::PPU::reset_foreground_data() {
+template<class MapperType>
+void cynes::PPU<MapperType>::reset_foreground_data() {
     _foreground_sprite_count_next = _foreground_sprite_count;
 
     _foreground_data_pointer = 0;
@@ -729,7 +1072,8 @@ void cynes::PPU::reset_foreground_data() {
     _foreground_sprite_zero_hit = false;
 }
 
-void cynes::PPU::clear_foreground_data() {
+template<class MapperType>
+void cynes::PPU<MapperType>::clear_foreground_data() {
     if (_current_x & 0x01) {
         _foreground_data[_foreground_data_pointer++] = 0xFF;
 
@@ -737,7 +1081,8 @@ void cynes::PPU::clear_foreground_data() {
     }
 }
 
-void cynes::PPU::fetch_foreground_data() {
+template<class MapperType>
+void cynes::PPU<MapperType>::fetch_foreground_data() {
     if (_current_x % 2 == 0 && _rendering_enabled) {
         uint8_t sprite_size = _control_foreground_large ? 16 : 8;
 
@@ -809,7 +1154,8 @@ void cynes::PPU::fetch_foreground_data() {
     }
 }
 
-void cynes::PPU::load_foreground_shifter() {
+template<class MapperType>
+void cynes::PPU<MapperType>::load_foreground_shifter() {
     if (_rendering_enabled) {
         _foreground_sprite_pointer = 0;
 
@@ -822,7 +1168,7 @@ void cynes::PPU::load_foreground_shifter() {
             uint16_t address = 0x2000;
             address |= _register_v & 0x0FFF;
 
-            _nes.read_ppu(address);
+            _nes.fetch_ppu(address);
 
             break;
         }
@@ -833,7 +1179,7 @@ void cynes::PPU::load_foreground_shifter() {
             address |= (_register_v >> 4) & 0x38;
             address |= (_register_v >> 2) & 0x07;
 
-            _nes.read_ppu(address);
+            _nes.fetch_ppu(address);
 
             break;
         }
@@ -876,30 +1222,24 @@ void cynes::PPU::load_foreground_shifter() {
                 _foreground_sprite_address |= offset & 0x07;
             }
 
-            uint8_t sprite_pattern_lsb_plane = _nes.read_ppu(_foreground_sprite_address);
-
+            uint8_t sprite_pattern_lsb_plane = _nes.fetch_ppu(_foreground_sprite_address);
 
             if (sprite_attribute & 0x40) {
-                sprite_pattern_lsb_plane = (sprite_pattern_lsb_plane & 0xF0) >> 4 | (sprite_pattern_lsb_plane & 0x0F) << 4;
-                sprite_pattern_lsb_plane = (sprite_pattern_lsb_plane & 0xCC) >> 2 | (sprite_pattern_lsb_plane & 0x33) << 2;
-                sprite_pattern_lsb_plane = (sprite_pattern_lsb_plane & 0xAA) >> 1 | (sprite_pattern_lsb_plane & 0x55) << 1;
+                sprite_pattern_lsb_plane = TileCache::mirror(sprite_pattern_lsb_plane);
             }
 
-            _foreground_shifter[_foreground_data_pointer * 2] = sprite_pattern_lsb_plane;
+            uint16_t& shifter = _foreground_shifter[_foreground_data_pointer];
+            shifter = (shifter & 0xAAAA) | TileCache::spread(sprite_pattern_lsb_plane);
 
             break;
         }
 
         case 0x7: {
-            uint8_t sprite_pattern_msb_plane = _nes.read_ppu(_foreground_sprite_address + 8);
+            bool flip = _foreground_data[_foreground_data_pointer * 4 + 2] & 0x40;
 
-            if (_foreground_data[_foreground_data_pointer * 4 + 2] & 0x40) {
-                sprite_pattern_msb_plane = (sprite_pattern_msb_plane & 0xF0) >> 4 | (sprite_pattern_msb_plane & 0x0F) << 4;
-                sprite_pattern_msb_plane = (sprite_pattern_msb_plane & 0xCC) >> 2 | (sprite_pattern_msb_plane & 0x33) << 2;
-                sprite_pattern_msb_plane = (sprite_pattern_msb_plane & 0xAA) >> 1 | (sprite_pattern_msb_plane & 0x55) << 1;
-            }
+            uint16_t& shifter = _foreground_shifter[_foreground_data_pointer];
+            shifter = _nes.fetch_tile_row(_foreground_sprite_address + 8, shifter, flip);
 
-            _foreground_shifter[_foreground_data_pointer * 2 + 1] = sprite_pattern_msb_plane;
             _foreground_positions[_foreground_data_pointer] = _foreground_data[_foreground_data_pointer * 4 + 3];
             _foreground_attributes[_foreground_data_pointer] = _foreground_data[_foreground_data_pointer * 4 + 2];
 
@@ -911,20 +1251,21 @@ void cynes::PPU::load_foreground_shifter() {
     }
 }
 
-void cynes::PPU::update_foreground_shifter() {
+template<class MapperType>
+void cynes::PPU<MapperType>::update_foreground_shifter() {
     if (_mask_render_foreground) {
         for (uint8_t sprite = 0; sprite < _foreground_sprite_count_next; sprite++) {
             if (_foreground_positions[sprite] > 0) {
                 _foreground_positions[sprite] --;
             } else {
-                _foreground_shifter[sprite * 2] <<= 1;
-                _foreground_shifter[sprite * 2 + 1] <<= 1;
+                _foreground_shifter[sprite] <<= 2;
             }
         }
     }
 }
 
-uint8_t cynes::PPU::blend_colors() {
+template<class MapperType>
+uint8_t cynes::PPU<MapperType>::blend_colors() {
     if (!_rendering_enabled && (_register_v & 0x3FFF) >= 0x3F00) {
         return _register_v & 0x1F;
     }
@@ -933,10 +1274,10 @@ uint8_t cynes::PPU::blend_colors() {
     uint8_t background_palette = 0x00;
 
     if (_mask_render_background && (_current_x > 8 || _mask_render_background_left)) {
-        uint16_t bit_mask = 0x8000 >> _scroll_x;
+        uint8_t shift = 30 - (_scroll_x << 1);
 
-        background_pixel = ((_background_shifter[0] & bit_mask) > 0) | (((_background_shifter[1] & bit_mask) > 0) << 1);
-        background_palette = ((_background_shifter[2] & bit_mask) > 0) | (((_background_shifter[3] & bit_mask) > 0) << 1);
+        background_pixel = (_background_shifter[0] >> shift) & 0x03;
+        background_palette = (_background_shifter[1] >> shift) & 0x03;
     }
 
     uint8_t foreground_pixel = 0x00;
@@ -948,7 +1289,7 @@ uint8_t cynes::PPU::blend_colors() {
 
         for (uint8_t sprite = 0; sprite < _foreground_sprite_count_next; sprite++) {
             if (_foreground_positions[sprite] == 0) {
-                foreground_pixel = ((_foreground_shifter[sprite * 2] & 0x80) > 0) | (((_foreground_shifter[sprite * 2 + 1] & 0x80) > 0) << 1);
+                foreground_pixel = _foreground_shifter[sprite] >> 14;
                 foreground_palette = (_foreground_attributes[sprite] & 0x03) + 0x04;
                 foreground_priority = (_foreground_attributes[sprite] & 0x20) == 0x00;
 
@@ -994,3 +1335,45 @@ uint8_t cynes::PPU::blend_colors() {
 
     return final_pixel;
 }
+
+template<class MapperType>
+void cynes::PPU<MapperType>::update_sprite_zero_hit() {
+    if (!_rendering_enabled && (_register_v & 0x3FFF) >= 0x3F00) {
+        return;
+    }
+
+    if (!_mask_render_foreground || (_current_x <= 8 && !_mask_render_foreground_left)) {
+        return;
+    }
+
+    _foreground_sprite_zero_hit = false;
+
+    if (_foreground_sprite_count_next == 0 || _foreground_positions[0] != 0) {
+        return;
+    }
+
+    if ((_foreground_shifter[0] & 0xC000) == 0 || _current_x == 256) {
+        return;
+    }
+
+    _foreground_sprite_zero_hit = true;
+
+    if (!_foreground_sprite_zero_line || !_mask_render_background || (_current_x <= 8 && !_mask_render_background_left)) {
+        return;
+    }
+
+    if ((_background_shifter[0] >> (30 - (_scroll_x << 1))) & 0x03) {
+        _status_sprite_zero_hit = true;
+    }
+}
+
+
+template class cynes::PPU<cynes::NROM>;
+template class cynes::PPU<cynes::MMC1>;
+template class cynes::PPU<cynes::UxROM>;
+template class cynes::PPU<cynes::CNROM>;
+template class cynes::PPU<cynes::MMC3>;
+template class cynes::PPU<cynes::AxROM>;
+template class cynes::PPU<cynes::MMC2>;
+template class cynes::PPU<cynes::MMC4>;
+template class cynes::PPU<cynes::GxROM>;
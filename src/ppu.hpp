@@ -8,13 +8,44 @@
 
 namespace cynes {
 // Forward declaration.
-class NES;
+template<class MapperType> class NESCore;
+
+/// Format of the pixels output by the PPU.
+enum class FrameFormat : uint8_t {
+    /// 240x256x3 RGB colors.
+    RGB,
+    /// 240x256 palette indices (6-bit NES color codes), with the color emphasis bits
+    /// stored once per scanline.
+    PALETTE
+};
+
+/// Get the RGB color of a palette index.
+/// @param index Palette index (6-bit NES color code).
+/// @param emphasis Color emphasis bits.
+/// @return The three components of the color.
+const uint8_t* get_palette_color(uint8_t index, uint8_t emphasis);
+
+/// Convert a frame of palette indices to RGB colors.
+/// @param indices Palette indices of the frame (240x256).
+/// @param emphasis Color emphasis bits of each scanline (240).
+/// @param frame_buffer Output RGB frame (240x256x3).
+void convert_palette_indices(
+    const uint8_t* indices,
+    const uint8_t* emphasis,
+    uint8_t* frame_buffer
+);
 
 /// Picture Processing Unit (see https://www.nesdev.org/wiki/PPU).
+template<class MapperType>
 class PPU {
 public:
     /// Initialize the PPU.
-    PPU(NES& nes);
+    PPU(NESCore<MapperType>& nes);
+
+    /// Initialize the PPU as a copy of another PPU.
+    /// @param nes Emulator owning the new PPU.
+    /// @param other PPU to copy the state from.
+    PPU(NESCore<MapperType>& nes, const PPU& other);
 
     /// Default destructor.
     ~PPU() = default;
@@ -29,6 +60,24 @@ public:
     /// Tick the PPU.
     void tick();
 
+    /// Check whether or not the rest of the current scanline can be rendered at once.
+    /// @note This is the case at the start of a visible scanline, when no delayed write
+    /// of the address register or change of the rendering state is pending. The caller
+    /// is responsible for making sure that the CPU cannot access the PPU registers, nor
+    /// switch the mapper banks, before the end of the scanline.
+    /// @return True if `render_scanline` can be used, false otherwise.
+    inline bool can_render_scanline() const {
+        return _current_x == 0 && _current_y < 240 && _delay_data_write_counter == 0
+            && _rendering_enabled_delayed == _rendering_enabled
+            && _rendering_enabled == (_mask_render_background || _mask_render_foreground);
+    }
+
+    /// Run the PPU until the end of the current visible scanline (340 dots).
+    /// @note The scanline is rendered at once instead of dot by dot, the state of the
+    /// PPU, the memory accesses and the pixels output are identical to the ones of as
+    /// many calls to `tick`. Should only be called if `can_render_scanline` is true.
+    void render_scanline();
+
     /// Write to the PPU memory.
     /// @note This function has other side effects than simply writing to the memory, it
     /// should not be used as a memory set function.
@@ -46,16 +95,69 @@ public:
     /// Get a pointer to the internal frame buffer.
     const uint8_t* get_frame_buffer() const;
 
+    /// Get a pointer to the internal palette index buffer.
+    /// @note The buffer is only written while the frame format is `FrameFormat::PALETTE`.
+    const uint8_t* get_index_buffer() const;
+
+    /// Get a pointer to the color emphasis bits of each scanline.
+    /// @note The buffer is only written while the frame format is `FrameFormat::PALETTE`.
+    /// A scanline holds the emphasis bits set when its last pixel was output.
+    const uint8_t* get_emphasis_buffer() const;
+
+    /// Set the format of the pixels output by the PPU.
+    /// @param format New frame format.
+    void set_frame_format(FrameFormat format);
+
+    /// Get the format of the pixels output by the PPU.
+    /// @return The current frame format.
+    FrameFormat get_frame_format() const;
+
+    /// Convert the content of the palette index buffer to RGB colors, and write them in
+    /// the frame buffer.
+    void convert_frame_buffer();
+
+    /// Enable or disable the pixel output.
+    /// @note While the output is disabled, the frame buffer is left untouched but the
+    /// sprite zero hit is still detected, every other part of the rendering runs as
+    /// usual.
+    /// @param skip True to disable the pixel output, false to enable it.
+    void set_render_skip(bool skip);
+
+    /// Redirect the pixel output to an external buffer.
+    /// @note The target receives the pixels in the current frame format, it must hold
+    /// 240x256x3 bytes with the `FrameFormat::RGB` format and 240x256 bytes with the
+    /// `FrameFormat::PALETTE` format. The pixels of the current frame already output are
+    /// copied to the new target, the internal buffers are not updated while a target is
+    /// set.
+    /// @param target Output buffer, or a null pointer to restore the internal buffers.
+    void set_frame_target(uint8_t* target);
+
     /// Check whether or not the frame is ready.
     /// @note Calling this function will reset the flag.
     /// @return True if the frame is ready, false otherwise.
     bool is_frame_ready();
 
+    /// Get the number of dots the PPU can run before it may change the non-maskable
+    /// interrupt line, complete a frame or start a new one.
+    /// @note The distance is one dot short of the exact value, so that it stays valid
+    /// whether or not the odd frame dot is skipped.
+    /// @return The number of dots before the next event.
+    uint32_t get_event_distance() const;
+
 private:
-    NES& _nes;
+    NESCore<MapperType>& _nes;
 
 private:
     std::unique_ptr<uint8_t[]> _frame_buffer;
+    std::unique_ptr<uint8_t[]> _index_buffer;
+    std::unique_ptr<uint8_t[]> _emphasis_buffer;
+
+    uint8_t* _frame_output;
+    uint8_t* _index_output;
+
+    FrameFormat _frame_format;
+
+    bool _render_skip;
 
     uint16_t _current_x;
     uint16_t _current_y;
@@ -112,15 +214,22 @@ private:
     void reset_scroll_y();
 
 private:
-    uint8_t _background_data[0x4];
-    uint16_t _background_shifter[0x4];
+    uint8_t _background_data[0x2];
+    uint16_t _background_row;
+    uint32_t _background_shifter[0x2];
 
     void load_background_shifters();
     void update_background_shifters();
+    void reload_background_shifters();
+
+    void fetch_background_name();
+    void fetch_background_attribute();
+    void fetch_background_pattern_low();
+    void fetch_background_pattern_high();
 
 private:
     uint8_t _foreground_data[0x20];
-    uint8_t _foreground_shifter[0x10];
+    uint16_t _foreground_shifter[0x8];
     uint8_t _foreground_attributes[0x8];
     uint8_t _foreground_positions[0x8];
 
@@ -148,6 +257,10 @@ private:
 
     uint8_t blend_colors();
 
+    /// Update the sprite zero hit flags exactly as `blend_colors` would, without
+    /// computing the pixel color.
+    void update_sprite_zero_hit();
+
 private:
     enum class Register : uint8_t {
         PPU_CTRL = 0x00,
@@ -201,6 +314,7 @@ public:
         cynes::dump<operation>(buffer, _buffer_data);
 
         cynes::dump<operation>(buffer, _background_data);
+        cynes::dump<operation>(buffer, _background_row);
         cynes::dump<operation>(buffer, _background_shifter);
 
         cynes::dump<operation>(buffer, _foreground_data);
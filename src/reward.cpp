@@ -0,0 +1,519 @@
+#include "reward.hpp"
+#include "emulator.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+
+constexpr uint16_t MAXIMUM_BCD_BYTES = 0x07;
+constexpr uint16_t MAXIMUM_DIGITS = 0x0F;
+constexpr size_t MAXIMUM_NESTING = 0x100;
+
+
+// Addresses wrap around the console address space, non-finite values map to zero.
+inline uint16_t get_address(double value) {
+    if (!std::isfinite(value)) {
+        return 0x0000;
+    }
+
+    return static_cast<uint16_t>(static_cast<int64_t>(std::fmod(value, 65536.0)));
+}
+
+// Integer part of a value, used by bitwise operators, zero if it is not representable.
+inline int64_t get_integer(double value) {
+    if (!(std::fabs(value) < 9.0e18)) {
+        return 0;
+    }
+
+    return static_cast<int64_t>(value);
+}
+
+
+namespace cynes {
+/// Recursive descent parser compiling a `MemoryExpression`.
+/// Operators are parsed by increasing precedence level, each level emitting the
+/// bytecode of its operands before its own instruction.
+class ExpressionParser {
+public:
+    ExpressionParser(const std::string& source, MemoryExpression& expression)
+        : _source{source}
+        , _position{0}
+        , _expression{expression}
+        , _depth{0}
+        , _maximum_depth{0}
+        , _nesting{0} { }
+
+public:
+    void parse() {
+        skip_spaces();
+
+        if (_position == _source.size()) {
+            emit(OpCode::PUSH, 1, 0x0000, 0.0);
+        } else {
+            parse_or();
+        }
+
+        skip_spaces();
+
+        if (_position != _source.size()) {
+            fail("Unexpected character");
+        }
+
+        _expression._stack.resize(_maximum_depth);
+    }
+
+private:
+    using OpCode = MemoryExpression::OpCode;
+
+    const std::string& _source;
+    size_t _position;
+
+    MemoryExpression& _expression;
+
+    size_t _depth;
+    size_t _maximum_depth;
+
+    size_t _nesting;
+
+private:
+    [[noreturn]] void fail(const char* message) const {
+        throw std::runtime_error(
+            std::string{message} + " at position " + std::to_string(_position)
+            + " of expression \"" + _source + "\"."
+        );
+    }
+
+    void emit(OpCode opcode, int8_t depth, uint16_t operand = 0x0000, double value = 0.0) {
+        _depth += depth;
+        _maximum_depth = std::max(_maximum_depth, _depth);
+
+        _expression._program.push_back({opcode, operand, value});
+    }
+
+    void skip_spaces() {
+        while (_position < _source.size() && std::isspace(static_cast<unsigned char>(_source[_position]))) {
+            _position++;
+        }
+    }
+
+    bool match(const char* token, const char* exclude = nullptr) {
+        skip_spaces();
+
+        if (exclude != nullptr && _source.compare(_position, std::strlen(exclude), exclude) == 0) {
+            return false;
+        }
+
+        if (_source.compare(_position, std::strlen(token), token) != 0) {
+            return false;
+        }
+
+        _position += std::strlen(token);
+
+        return true;
+    }
+
+    void expect(const char* token) {
+        if (!match(token)) {
+            fail((std::string{"Expected '"} + token + "'").c_str());
+        }
+    }
+
+private:
+    void parse_or() {
+        parse_and();
+
+        while (match("||")) {
+            parse_and();
+            emit(OpCode::OR, -1);
+        }
+    }
+
+    void parse_and() {
+        parse_bit_or();
+
+        while (match("&&")) {
+            parse_bit_or();
+            emit(OpCode::AND, -1);
+        }
+    }
+
+    void parse_bit_or() {
+        parse_bit_xor();
+
+        while (match("|", "||")) {
+            parse_bit_xor();
+            emit(OpCode::BIT_OR, -1);
+        }
+    }
+
+    void parse_bit_xor() {
+        parse_bit_and();
+
+        while (match("^")) {
+            parse_bit_and();
+            emit(OpCode::BIT_XOR, -1);
+        }
+    }
+
+    void parse_bit_and() {
+        parse_equality();
+
+        while (match("&", "&&")) {
+            parse_equality();
+            emit(OpCode::BIT_AND, -1);
+        }
+    }
+
+    void parse_equality() {
+        parse_relational();
+
+        while (true) {
+            if (match("==")) {
+                parse_relational();
+                emit(OpCode::EQ, -1);
+            } else if (match("!=")) {
+                parse_relational();
+                emit(OpCode::NE, -1);
+            } else {
+                break;
+            }
+        }
+    }
+
+    void parse_relational() {
+        parse_additive();
+
+        while (true) {
+            if (match("<=")) {
+                parse_additive();
+                emit(OpCode::LE, -1);
+            } else if (match(">=")) {
+                parse_additive();
+                emit(OpCode::GE, -1);
+            } else if (match("<")) {
+                parse_additive();
+                emit(OpCode::LT, -1);
+            } else if (match(">")) {
+                parse_additive();
+                emit(OpCode::GT, -1);
+            } else {
+                break;
+            }
+        }
+    }
+
+    void parse_additive() {
+        parse_multiplicative();
+
+        while (true) {
+            if (match("+")) {
+                parse_multiplicative();
+                emit(OpCode::ADD, -1);
+            } else if (match("-")) {
+                parse_multiplicative();
+                emit(OpCode::SUB, -1);
+            } else {
+                break;
+            }
+        }
+    }
+
+    void parse_multiplicative() {
+        parse_unary();
+
+        while (true) {
+            if (match("*")) {
+                parse_unary();
+                emit(OpCode::MUL, -1);
+            } else if (match("/")) {
+                parse_unary();
+                emit(OpCode::DIV, -1);
+            } else if (match("%")) {
+                parse_unary();
+                emit(OpCode::MOD, -1);
+            } else {
+                break;
+            }
+        }
+    }
+
+    // Parentheses, function calls and unary operators all nest through this function,
+    // bounding it keeps the recursion from overflowing the native stack.
+    void parse_unary() {
+        if (++_nesting > MAXIMUM_NESTING) {
+            fail("Expression is nested too deeply");
+        }
+
+        if (match("-")) {
+            parse_unary();
+            emit(OpCode::NEG, 0);
+        } else if (match("!", "!=")) {
+            parse_unary();
+            emit(OpCode::NOT, 0);
+        } else if (match("+")) {
+            parse_unary();
+        } else {
+            parse_primary();
+        }
+
+        _nesting--;
+    }
+
+    void parse_primary() {
+        skip_spaces();
+
+        if (match("(")) {
+            parse_or();
+            expect(")");
+            return;
+        }
+
+        if (_position < _source.size() && (std::isdigit(static_cast<unsigned char>(_source[_position])) || _source[_position] == '.')) {
+            emit(OpCode::PUSH, 1, 0x0000, parse_number());
+            return;
+        }
+
+        std::string name = parse_identifier();
+
+        expect("(");
+
+        if (name == "u8" || name == "s8" || name == "u16") {
+            parse_or();
+            emit(name == "u8" ? OpCode::READ_U8 : name == "s8" ? OpCode::READ_S8 : OpCode::READ_U16, 0);
+        } else if (name == "bcd" || name == "digits") {
+            parse_or();
+            expect(",");
+
+            uint16_t count = parse_count(name == "bcd" ? MAXIMUM_BCD_BYTES : MAXIMUM_DIGITS);
+
+            emit(name == "bcd" ? OpCode::READ_BCD : OpCode::READ_DIGITS, 0, count);
+        } else if (name == "delta") {
+            parse_or();
+            emit(OpCode::DELTA, 0, static_cast<uint16_t>(_expression._deltas.size()));
+
+            _expression._deltas.push_back(0.0);
+        } else if (name == "min" || name == "max") {
+            parse_or();
+            expect(",");
+            parse_or();
+            emit(name == "min" ? OpCode::MIN : OpCode::MAX, -1);
+        } else if (name == "abs") {
+            parse_or();
+            emit(OpCode::ABS, 0);
+        } else if (name == "clip") {
+            parse_or();
+            expect(",");
+            parse_or();
+            expect(",");
+            parse_or();
+            emit(OpCode::CLIP, -2);
+        } else {
+            fail(("Unknown function '" + name + "'").c_str());
+        }
+
+        expect(")");
+    }
+
+    double parse_number() {
+        const char* begin = _source.c_str() + _position;
+        char* end = nullptr;
+
+        double value;
+
+        if (_source.compare(_position, 2, "0x") == 0 || _source.compare(_position, 2, "0X") == 0) {
+            value = static_cast<double>(std::strtoll(begin, &end, 16));
+        } else {
+            value = std::strtod(begin, &end);
+        }
+
+        if (end == begin) {
+            fail("Invalid number");
+        }
+
+        _position += end - begin;
+
+        return value;
+    }
+
+    uint16_t parse_count(uint16_t maximum) {
+        skip_spaces();
+
+        if (_position == _source.size() || !std::isdigit(static_cast<unsigned char>(_source[_position]))) {
+            fail("Expected a constant count");
+        }
+
+        double count = parse_number();
+
+        if (count < 1 || count > maximum || count != std::floor(count)) {
+            fail(("The count must be an integer between 1 and " + std::to_string(maximum)).c_str());
+        }
+
+        return static_cast<uint16_t>(count);
+    }
+
+    std::string parse_identifier() {
+        size_t begin = _position;
+
+        while (_position < _source.size() && (std::isalnum(static_cast<unsigned char>(_source[_position])) || _source[_position] == '_')) {
+            _position++;
+        }
+
+        if (_position == begin) {
+            fail("Expected an expression");
+        }
+
+        return _source.substr(begin, _position - begin);
+    }
+};
+}
+
+
+cynes::MemoryExpression::MemoryExpression(const std::string& source)
+    : _program{}
+    , _stack{}
+    , _deltas{}
+    , _deltas_valid{false}
+{
+    ExpressionParser{source, *this}.parse();
+}
+
+double cynes::MemoryExpression::evaluate(const Emulator& nes) {
+    double* stack = _stack.data();
+    size_t top = 0;
+
+    uint8_t memory[MAXIMUM_DIGITS];
+
+    for (const Instruction& instruction : _program) {
+        switch (instruction.opcode) {
+        case OpCode::PUSH: stack[top++] = instruction.value; break;
+
+        case OpCode::READ_U8:
+            nes.peek(get_address(stack[top - 1]), memory, 1);
+            stack[top - 1] = memory[0];
+            break;
+
+        case OpCode::READ_S8:
+            nes.peek(get_address(stack[top - 1]), memory, 1);
+            stack[top - 1] = static_cast<int8_t>(memory[0]);
+            break;
+
+        case OpCode::READ_U16:
+            nes.peek(get_address(stack[top - 1]), memory, 2);
+            stack[top - 1] = memory[0] | (memory[1] << 8);
+            break;
+
+        case OpCode::READ_BCD:
+        case OpCode::READ_DIGITS: {
+            double value = 0.0;
+
+            nes.peek(get_address(stack[top - 1]), memory, instruction.operand);
+
+            for (uint16_t k = 0; k < instruction.operand; k++) {
+                if (instruction.opcode == OpCode::READ_BCD) {
+                    value = value * 100 + (memory[k] >> 4) * 10 + (memory[k] & 0x0F);
+                } else {
+                    value = value * 10 + memory[k];
+                }
+            }
+
+            stack[top - 1] = value;
+            break;
+        }
+
+        case OpCode::DELTA: {
+            double value = stack[top - 1];
+            double previous = _deltas_valid ? _deltas[instruction.operand] : value;
+
+            _deltas[instruction.operand] = value;
+            stack[top - 1] = value - previous;
+            break;
+        }
+
+        case OpCode::ADD: top--; stack[top - 1] += stack[top]; break;
+        case OpCode::SUB: top--; stack[top - 1] -= stack[top]; break;
+        case OpCode::MUL: top--; stack[top - 1] *= stack[top]; break;
+
+        case OpCode::DIV:
+            top--;
+            stack[top - 1] = stack[top] == 0.0 ? 0.0 : stack[top - 1] / stack[top];
+            break;
+
+        case OpCode::MOD:
+            top--;
+            stack[top - 1] = stack[top] == 0.0 ? 0.0 : std::fmod(stack[top - 1], stack[top]);
+            break;
+
+        case OpCode::BIT_AND:
+            top--;
+            stack[top - 1] = static_cast<double>(get_integer(stack[top - 1]) & get_integer(stack[top]));
+            break;
+
+        case OpCode::BIT_OR:
+            top--;
+            stack[top - 1] = static_cast<double>(get_integer(stack[top - 1]) | get_integer(stack[top]));
+            break;
+
+        case OpCode::BIT_XOR:
+            top--;
+            stack[top - 1] = static_cast<double>(get_integer(stack[top - 1]) ^ get_integer(stack[top]));
+            break;
+
+        case OpCode::EQ: top--; stack[top - 1] = stack[top - 1] == stack[top]; break;
+        case OpCode::NE: top--; stack[top - 1] = stack[top - 1] != stack[top]; break;
+        case OpCode::LT: top--; stack[top - 1] = stack[top - 1] < stack[top]; break;
+        case OpCode::LE: top--; stack[top - 1] = stack[top - 1] <= stack[top]; break;
+        case OpCode::GT: top--; stack[top - 1] = stack[top - 1] > stack[top]; break;
+        case OpCode::GE: top--; stack[top - 1] = stack[top - 1] >= stack[top]; break;
+        case OpCode::AND: top--; stack[top - 1] = stack[top - 1] != 0.0 && stack[top] != 0.0; break;
+        case OpCode::OR: top--; stack[top - 1] = stack[top - 1] != 0.0 || stack[top] != 0.0; break;
+
+        case OpCode::NEG: stack[top - 1] = -stack[top - 1]; break;
+        case OpCode::NOT: stack[top - 1] = stack[top - 1] == 0.0; break;
+
+        case OpCode::MIN: top--; stack[top - 1] = std::min(stack[top - 1], stack[top]); break;
+        case OpCode::MAX: top--; stack[top - 1] = std::max(stack[top - 1], stack[top]); break;
+        case OpCode::ABS: stack[top - 1] = std::fabs(stack[top - 1]); break;
+
+        case OpCode::CLIP:
+            top -= 2;
+            stack[top - 1] = std::min(std::max(stack[top - 1], stack[top]), stack[top + 1]);
+            break;
+        }
+    }
+
+    _deltas_valid = true;
+
+    return stack[0];
+}
+
+void cynes::MemoryExpression::clear() {
+    _deltas_valid = false;
+}
+
+
+cynes::RewardFunction::RewardFunction(const std::string& reward, const std::string& done)
+    : _reward_expression{reward}
+    , _done_expression{done}
+    , _reward{0.0}
+    , _done{false} { }
+
+void cynes::RewardFunction::update(const Emulator& nes) {
+    _reward += _reward_expression.evaluate(nes);
+    _done |= _done_expression.evaluate(nes) != 0.0;
+}
+
+void cynes::RewardFunction::begin_step() {
+    _reward = 0.0;
+    _done = false;
+}
+
+void cynes::RewardFunction::clear() {
+    _reward_expression.clear();
+    _done_expression.clear();
+
+    begin_step();
+}
@@ -0,0 +1,114 @@
+#ifndef __CYNES_REWARD__
+#define __CYNES_REWARD__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "emulator.hpp"
+
+namespace cynes {
+// Forward declaration.
+class ExpressionParser;
+
+/// Expression over the console memory, compiled to a stack bytecode.
+/// The syntax is close to C, every value is a double precision number:
+/// - literals: `12`, `0x7E`, `0.5`;
+/// - arithmetic: `+`, `-`, `*`, `/`, `%`, bitwise `&`, `|`, `^` (on integer parts);
+/// - comparisons: `==`, `!=`, `<`, `<=`, `>`, `>=`, logical `&&`, `||`, `!`;
+/// - memory reads: `u8(address)`, `s8(address)`, `u16(address)` (little-endian);
+/// - decimal decoding: `bcd(address, count)` for packed BCD bytes and
+///   `digits(address, count)` for one digit per byte, most significant first;
+/// - `delta(expression)`, difference with the value of the expression at the previous
+///   evaluation (zero on the first evaluation);
+/// - `min(a, b)`, `max(a, b)`, `abs(a)`, `clip(a, low, high)`.
+/// @note Memory is read without side effect (see `Emulator::peek`). Logical operators
+/// do not short-circuit, so that every `delta` is updated at each evaluation.
+class MemoryExpression {
+public:
+    /// Compile an expression.
+    /// @note An empty source evaluates to zero.
+    /// @param source Source of the expression.
+    MemoryExpression(const std::string& source);
+
+    /// Default destructor.
+    ~MemoryExpression() = default;
+
+public:
+    /// Evaluate the expression.
+    /// @param nes Emulator whose memory is read.
+    /// @return The value of the expression.
+    double evaluate(const Emulator& nes);
+
+    /// Forget the values recorded by `delta`.
+    void clear();
+
+private:
+    enum class OpCode : uint8_t {
+        PUSH, READ_U8, READ_S8, READ_U16, READ_BCD, READ_DIGITS, DELTA,
+        ADD, SUB, MUL, DIV, MOD, BIT_AND, BIT_OR, BIT_XOR,
+        EQ, NE, LT, LE, GT, GE, AND, OR, NEG, NOT,
+        MIN, MAX, ABS, CLIP
+    };
+
+    struct Instruction {
+    public:
+        OpCode opcode = OpCode::PUSH;
+        uint16_t operand = 0x0000;
+        double value = 0.0;
+    };
+
+    std::vector<Instruction> _program;
+    std::vector<double> _stack;
+
+    std::vector<double> _deltas;
+    bool _deltas_valid;
+
+    friend class ExpressionParser;
+};
+
+/// Reward and termination conditions of an environment, evaluated after every frame.
+class RewardFunction {
+public:
+    /// Compile the reward and done expressions (see `MemoryExpression`).
+    /// @param reward Reward expression, summed over the frames of a step.
+    /// @param done Termination expression, a step is done if it is non-zero after any
+    /// of its frames.
+    RewardFunction(const std::string& reward, const std::string& done);
+
+    /// Default destructor.
+    ~RewardFunction() = default;
+
+public:
+    /// Evaluate the expressions after a frame, and accumulate their values.
+    /// @param nes Emulator whose memory is read.
+    void update(const Emulator& nes);
+
+    /// Clear the accumulated reward and done flag before a step.
+    void begin_step();
+
+    /// Forget the history of the expressions, after the emulator was reset or loaded.
+    void clear();
+
+    /// Get the reward accumulated since the last call to `RewardFunction::begin_step`.
+    inline double get_reward() const {
+        return _reward;
+    }
+
+    /// Check whether or not the done expression was met since the last call to
+    /// `RewardFunction::begin_step`.
+    inline bool is_done() const {
+        return _done;
+    }
+
+private:
+    MemoryExpression _reward_expression;
+    MemoryExpression _done_expression;
+
+    double _reward;
+    bool _done;
+};
+}
+
+#endif
@@ -0,0 +1,19 @@
+#include "tiles.hpp"
+
+
+cynes::TileCache::TileCache() : _valid{}, _rows{} { }
+
+void cynes::TileCache::decode(const uint8_t* page, uint8_t slot, uint8_t tile) {
+    const uint8_t* planes = page + (tile << 4);
+    uint16_t (*rows)[0x2] = _rows[slot] + (tile << 3);
+
+    for (uint8_t k = 0; k < 8; k++) {
+        uint8_t lsb_plane = planes[k];
+        uint8_t msb_plane = planes[k + 8];
+
+        rows[k][0] = spread(lsb_plane) | spread(msb_plane) << 1;
+        rows[k][1] = spread(mirror(lsb_plane)) | spread(mirror(msb_plane)) << 1;
+    }
+
+    _valid[slot] |= uint64_t(1) << tile;
+}
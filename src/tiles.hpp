@@ -0,0 +1,86 @@
+#ifndef __CYNES_TILES__
+#define __CYNES_TILES__
+
+#include <cstdint>
+
+namespace cynes {
+/// Cache of the pattern tables ($0000-$1FFF) decoded to chunky rows.
+/// Each row of a tile is stored as 8 pixels of 2 bits, the leftmost pixel in the two
+/// most significant bits, both as is and horizontally mirrored. The cache is indexed
+/// by the 1KB pages of the PPU address space, tiles are decoded lazily on first use and
+/// must be invalidated whenever their page is remapped or their memory is written.
+class TileCache {
+public:
+    /// Initialize an empty cache.
+    TileCache();
+
+    /// Default destructor.
+    ~TileCache() = default;
+
+public:
+    /// Invalidate every tile of a pattern table page.
+    /// @param page Index of the 1KB page within the PPU address space.
+    inline void invalidate_page(uint8_t page) {
+        if (page < 0x8) {
+            _valid[page] = 0;
+        }
+    }
+
+    /// Invalidate the tile holding the given address.
+    /// @param address Memory address within the PPU address space.
+    inline void invalidate_tile(uint16_t address) {
+        if (address < 0x2000) {
+            _valid[address >> 10] &= ~(uint64_t(1) << ((address >> 4) & 0x3F));
+        }
+    }
+
+    /// Get a decoded row of a tile.
+    /// @param page Memory backing the page holding the tile.
+    /// @param address Memory address of one of the two planes of the row, below $2000.
+    /// @param flip True to get the horizontally mirrored row.
+    /// @return The row, 2 bits per pixel.
+    inline uint16_t get_row(const uint8_t* page, uint16_t address, bool flip) {
+        uint8_t slot = address >> 10;
+        uint8_t tile = (address >> 4) & 0x3F;
+
+        if (!((_valid[slot] >> tile) & 0x1)) {
+            decode(page, slot, tile);
+        }
+
+        return _rows[slot][((address & 0x3F0) >> 1) | (address & 0x7)][flip];
+    }
+
+    /// Spread the 8 bits of a plane over the even bits of a chunky row.
+    /// @param plane Plane of a tile row.
+    /// @return The plane bits, spaced out by one bit.
+    static inline uint16_t spread(uint8_t plane) {
+        uint16_t value = plane;
+
+        value = (value | (value << 4)) & 0x0F0F;
+        value = (value | (value << 2)) & 0x3333;
+        value = (value | (value << 1)) & 0x5555;
+
+        return value;
+    }
+
+    /// Reverse the bits of a plane.
+    /// @param plane Plane of a tile row.
+    /// @return The horizontally mirrored plane.
+    static inline uint8_t mirror(uint8_t plane) {
+        plane = (plane & 0xF0) >> 4 | (plane & 0x0F) << 4;
+        plane = (plane & 0xCC) >> 2 | (plane & 0x33) << 2;
+        plane = (plane & 0xAA) >> 1 | (plane & 0x55) << 1;
+
+        return plane;
+    }
+
+private:
+    uint64_t _valid[0x8];
+    uint16_t _rows[0x8][0x200][0x2];
+
+private:
+    void decode(const uint8_t* page, uint8_t slot, uint8_t tile);
+};
+}
+
+#endif
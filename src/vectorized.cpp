@@ -0,0 +1,342 @@
+#include "vectorized.hpp"
+#include "environment.hpp"
+#include "nes.hpp"
+#include "observation.hpp"
+#include "file.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+
+cynes::VectorNES::VectorNES(const char* path, size_t size, size_t threads)
+    : _emulators{}
+    , _frame_buffers{new uint8_t[size * FRAME_BUFFER_SIZE]{}}
+    , _index_buffers{new uint8_t[size * INDEX_BUFFER_SIZE]{}}
+    , _emphasis_buffers{new uint8_t[size * EMPHASIS_BUFFER_SIZE]{}}
+    , _frozen{new bool[size]{}}
+    , _rewards{new double[size]{}}
+    , _dones{new bool[size]{}}
+    , _frame_format{FrameFormat::RGB}
+    , _pipelines{}
+    , _observations{}
+    , _environments{}
+    , _pool{threads}
+{
+    MappedFile file{path};
+
+    load(file.data(), file.size(), size);
+}
+
+cynes::VectorNES::VectorNES(
+    const uint8_t* rom,
+    size_t rom_size,
+    size_t size,
+    size_t threads
+)
+    : _emulators{}
+    , _frame_buffers{new uint8_t[size * FRAME_BUFFER_SIZE]{}}
+    , _index_buffers{new uint8_t[size * INDEX_BUFFER_SIZE]{}}
+    , _emphasis_buffers{new uint8_t[size * EMPHASIS_BUFFER_SIZE]{}}
+    , _frozen{new bool[size]{}}
+    , _rewards{new double[size]{}}
+    , _dones{new bool[size]{}}
+    , _frame_format{FrameFormat::RGB}
+    , _pipelines{}
+    , _observations{}
+    , _environments{}
+    , _pool{threads}
+{
+    load(rom, rom_size, size);
+}
+
+size_t cynes::VectorNES::size() const {
+    return _emulators.size();
+}
+
+cynes::NES& cynes::VectorNES::get(size_t index) {
+    if (index >= _emulators.size()) {
+        throw std::out_of_range("The emulator index is out of range.");
+    }
+
+    return *_emulators[index];
+}
+
+void cynes::VectorNES::step(
+    const uint16_t* controllers,
+    unsigned int frames,
+    uint8_t* output
+) {
+    _pool.run(_emulators.size(), [this, controllers, frames, output](size_t index) {
+        NES& nes = *_emulators[index];
+        RewardFunction* reward_function = nes.get_reward_function();
+
+        if (reward_function) {
+            reward_function->begin_step();
+        }
+
+        if (_frozen[index]) {
+            _rewards[index] = 0.0;
+            _dones[index] = false;
+            return;
+        }
+
+        if (!_pipelines.empty()) {
+            ObservationPipeline& pipeline = *_pipelines[index];
+            uint8_t* observation = (output ? output : _observations.get()) + index * pipeline.size();
+
+            _frozen[index] = pipeline.step(nes, controllers[index], frames, observation);
+        } else {
+            step_frames(index, controllers[index], frames, output);
+        }
+
+        if (reward_function) {
+            _rewards[index] = reward_function->get_reward();
+            _dones[index] = reward_function->is_done();
+        }
+    });
+}
+
+void cynes::VectorNES::step_frames(
+    size_t index,
+    uint16_t controllers,
+    unsigned int frames,
+    uint8_t* output
+) {
+    NES& nes = *_emulators[index];
+
+    if (output) {
+        size_t frame_size = _frame_format == FrameFormat::PALETTE ? INDEX_BUFFER_SIZE : FRAME_BUFFER_SIZE;
+
+        nes.set_frame_target(output + index * frame_size);
+        _frozen[index] = nes.step(controllers, frames);
+        nes.set_frame_target(nullptr);
+    } else {
+        _frozen[index] = nes.step(controllers, frames);
+    }
+
+    copy_buffers(index, output != nullptr);
+}
+
+void cynes::VectorNES::copy_buffers(size_t index, bool in_place) {
+    NES& nes = *_emulators[index];
+
+    if (_frame_format == FrameFormat::PALETTE) {
+        if (!in_place) {
+            std::memcpy(
+                _index_buffers.get() + index * INDEX_BUFFER_SIZE,
+                nes.get_index_buffer(),
+                INDEX_BUFFER_SIZE
+            );
+        }
+
+        std::memcpy(
+            _emphasis_buffers.get() + index * EMPHASIS_BUFFER_SIZE,
+            nes.get_emphasis_buffer(),
+            EMPHASIS_BUFFER_SIZE
+        );
+    } else if (!in_place) {
+        std::memcpy(
+            _frame_buffers.get() + index * FRAME_BUFFER_SIZE,
+            nes.get_frame_buffer(),
+            FRAME_BUFFER_SIZE
+        );
+    }
+}
+
+void cynes::VectorNES::act(const uint16_t* actions) {
+    if (_environments.empty()) {
+        throw std::runtime_error("No environment is attached.");
+    }
+
+    _pool.run(_emulators.size(), [this, actions](size_t index) {
+        NES& nes = *_emulators[index];
+        RewardFunction* reward_function = nes.get_reward_function();
+
+        if (_frozen[index]) {
+            _rewards[index] = 0.0;
+            _dones[index] = false;
+            return;
+        }
+
+        if (!_pipelines.empty()) {
+            ObservationPipeline& pipeline = *_pipelines[index];
+            uint8_t* observation = _observations.get() + index * pipeline.size();
+
+            _frozen[index] = _environments[index]->step(nes, actions[index], &pipeline, observation);
+        } else {
+            _frozen[index] = _environments[index]->step(nes, actions[index]);
+
+            copy_buffers(index, false);
+        }
+
+        if (reward_function) {
+            _rewards[index] = reward_function->get_reward();
+            _dones[index] = reward_function->is_done();
+        }
+    });
+}
+
+void cynes::VectorNES::reset_environment(size_t index, uint8_t* state) {
+    if (index >= _emulators.size()) {
+        throw std::out_of_range("The emulator index is out of range.");
+    }
+
+    if (_environments.empty()) {
+        throw std::runtime_error("No environment is attached.");
+    }
+
+    NES& nes = *_emulators[index];
+
+    if (!_pipelines.empty()) {
+        ObservationPipeline& pipeline = *_pipelines[index];
+        uint8_t* observation = _observations.get() + index * pipeline.size();
+
+        _frozen[index] = _environments[index]->reset(nes, state, &pipeline, observation);
+    } else {
+        _frozen[index] = _environments[index]->reset(nes, state);
+
+        copy_buffers(index, false);
+    }
+}
+
+void cynes::VectorNES::set_environment_config(const EnvironmentConfig& config) {
+    std::vector<std::unique_ptr<Environment>> environments;
+    environments.reserve(_emulators.size());
+
+    for (size_t index = 0; index < _emulators.size(); index++) {
+        EnvironmentConfig seeded = config;
+        seeded.seed += index;
+
+        environments.push_back(std::make_unique<Environment>(seeded));
+    }
+
+    _environments = std::move(environments);
+}
+
+void cynes::VectorNES::clear_environment_config() {
+    _environments.clear();
+}
+
+bool cynes::VectorNES::has_environment() const {
+    return !_environments.empty();
+}
+
+bool cynes::VectorNES::is_frozen(size_t index) const {
+    if (index >= _emulators.size()) {
+        throw std::out_of_range("The emulator index is out of range.");
+    }
+
+    return _frozen[index];
+}
+
+void cynes::VectorNES::clear_frozen(size_t index) {
+    if (index >= _emulators.size()) {
+        throw std::out_of_range("The emulator index is out of range.");
+    }
+
+    _frozen[index] = false;
+}
+
+void cynes::VectorNES::set_frame_format(FrameFormat format) {
+    for (auto& nes : _emulators) {
+        nes->set_frame_format(format);
+    }
+
+    _frame_format = format;
+}
+
+cynes::FrameFormat cynes::VectorNES::get_frame_format() const {
+    return _frame_format;
+}
+
+void cynes::VectorNES::convert_frame_buffers() {
+    _pool.run(_emulators.size(), [this](size_t index) {
+        convert_palette_indices(
+            _index_buffers.get() + index * INDEX_BUFFER_SIZE,
+            _emphasis_buffers.get() + index * EMPHASIS_BUFFER_SIZE,
+            _frame_buffers.get() + index * FRAME_BUFFER_SIZE
+        );
+    });
+}
+
+void cynes::VectorNES::set_observation_config(const ObservationConfig& config) {
+    std::vector<std::unique_ptr<ObservationPipeline>> pipelines;
+    pipelines.reserve(_emulators.size());
+
+    for (size_t index = 0; index < _emulators.size(); index++) {
+        pipelines.push_back(std::make_unique<ObservationPipeline>(config));
+    }
+
+    _observations.reset(new uint8_t[_emulators.size() * pipelines.front()->size()]{});
+    _pipelines = std::move(pipelines);
+}
+
+void cynes::VectorNES::clear_observation_config() {
+    _pipelines.clear();
+    _observations.reset();
+}
+
+bool cynes::VectorNES::has_observations() const {
+    return !_pipelines.empty();
+}
+
+size_t cynes::VectorNES::get_observation_size() const {
+    return _pipelines.empty() ? 0 : _pipelines.front()->size();
+}
+
+void cynes::VectorNES::clear_observation(size_t index) {
+    if (index >= _emulators.size()) {
+        throw std::out_of_range("The emulator index is out of range.");
+    }
+
+    if (!_pipelines.empty()) {
+        _pipelines[index]->clear();
+    }
+}
+
+void cynes::VectorNES::set_reward_function(const std::string& reward, const std::string& done) {
+    for (auto& nes : _emulators) {
+        nes->set_reward_function(reward, done);
+    }
+
+    std::fill_n(_rewards.get(), _emulators.size(), 0.0);
+    std::fill_n(_dones.get(), _emulators.size(), false);
+}
+
+void cynes::VectorNES::clear_reward_function() {
+    for (auto& nes : _emulators) {
+        nes->clear_reward_function();
+    }
+
+    std::fill_n(_rewards.get(), _emulators.size(), 0.0);
+    std::fill_n(_dones.get(), _emulators.size(), false);
+}
+
+bool cynes::VectorNES::has_reward_function() const {
+    return _emulators.front()->get_reward_function() != nullptr;
+}
+
+void cynes::VectorNES::set_render_skip(bool skip) {
+    for (auto& nes : _emulators) {
+        nes->set_render_skip(skip);
+    }
+}
+
+bool cynes::VectorNES::get_render_skip() const {
+    return _emulators.front()->get_render_skip();
+}
+
+void cynes::VectorNES::load(const uint8_t* rom, size_t rom_size, size_t size) {
+    if (size == 0) {
+        throw std::runtime_error("The number of emulators must be positive.");
+    }
+
+    _emulators.reserve(size);
+
+    for (size_t index = 0; index < size; index++) {
+        _emulators.push_back(std::make_unique<NES>(rom, rom_size));
+    }
+}
@@ -0,0 +1,225 @@
+#ifndef __CYNES_VECTORIZED__
+#define __CYNES_VECTORIZED__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "environment.hpp"
+#include "nes.hpp"
+#include "observation.hpp"
+#include "pool.hpp"
+
+namespace cynes {
+/// Batch of independent emulators running the same ROM, stepped in parallel.
+class VectorNES {
+public:
+    /// Initialize the emulators.
+    /// @param path Path to the ROM.
+    /// @param size Number of emulators.
+    /// @param threads Number of threads used to step the emulators. If zero, the number
+    /// of hardware threads is used.
+    VectorNES(const char* path, size_t size, size_t threads = 0);
+
+    /// Initialize the emulators from a ROM stored in memory.
+    /// @param rom Content of the ROM file.
+    /// @param rom_size Size of the ROM file.
+    /// @param size Number of emulators.
+    /// @param threads Number of threads used to step the emulators. If zero, the number
+    /// of hardware threads is used.
+    VectorNES(const uint8_t* rom, size_t rom_size, size_t size, size_t threads = 0);
+
+    /// Default destructor.
+    ~VectorNES() = default;
+
+public:
+    /// Get the number of emulators.
+    /// @return The number of emulators.
+    size_t size() const;
+
+    /// Get one of the emulators.
+    /// @param index Index of the emulator.
+    /// @return The emulator.
+    NES& get(size_t index);
+
+    /// Step every emulator by the given amount of frame.
+    /// @note Frozen emulators are not stepped, their part of the output buffer is left
+    /// untouched and their reward is zero.
+    /// @param controllers Controllers states of every emulator (see `NES::step`).
+    /// @param frames Number of frame of the step.
+    /// @param output Optional buffer receiving the frames, or the observations if a
+    /// pipeline is attached, of every emulator contiguously in emulator order. The
+    /// frames are then rendered in place and the internal buffers are not updated,
+    /// except for the emphasis buffers.
+    void step(const uint16_t* controllers, unsigned int frames, uint8_t* output = nullptr);
+
+    /// Execute an action on every emulator through their environments (see
+    /// `Environment::step`).
+    /// @note Frozen emulators are not stepped and their reward is zero. The frames, or
+    /// the observations if a pipeline is attached, are written in the internal buffers.
+    /// @param actions Controllers states of every emulator.
+    void act(const uint16_t* actions);
+
+    /// Reset an emulator through its environment (see `Environment::reset`).
+    /// @note This function also clears the frozen flag of the emulator, unless it
+    /// freezes again during the no-op frames.
+    /// @param index Index of the emulator.
+    /// @param state Optional save state loaded instead of resetting the console.
+    void reset_environment(size_t index, uint8_t* state = nullptr);
+
+    /// Attach an environment to every emulator.
+    /// @note The generator of each environment is seeded with `EnvironmentConfig::seed`
+    /// plus the index of its emulator.
+    /// @param config Environment settings.
+    void set_environment_config(const EnvironmentConfig& config);
+
+    /// Detach the environments.
+    void clear_environment_config();
+
+    /// Check whether or not environments are attached.
+    /// @return True if the emulators can be stepped through `VectorNES::act`, false
+    /// otherwise.
+    bool has_environment() const;
+
+    /// Check whether or not an emulator has hit an invalid opcode during a step.
+    /// @param index Index of the emulator.
+    /// @return True if the emulator is frozen, false otherwise.
+    bool is_frozen(size_t index) const;
+
+    /// Clear the frozen flag of an emulator after it was reset or loaded.
+    /// @param index Index of the emulator.
+    void clear_frozen(size_t index);
+
+    /// Set the format of the pixels output by every emulator (see
+    /// `NES::set_frame_format`).
+    /// @param format New frame format.
+    void set_frame_format(FrameFormat format);
+
+    /// Get the format of the pixels output by the emulators.
+    /// @return The current frame format.
+    FrameFormat get_frame_format() const;
+
+    /// Convert the palette index buffers of every emulator to RGB colors, in the frame
+    /// buffers.
+    void convert_frame_buffers();
+
+    /// Attach an observation pipeline to every emulator.
+    /// @note While a pipeline is attached, the emulators write their observations
+    /// instead of their frame buffers.
+    /// @param config Pipeline settings.
+    void set_observation_config(const ObservationConfig& config);
+
+    /// Detach the observation pipelines.
+    void clear_observation_config();
+
+    /// Check whether or not observation pipelines are attached.
+    /// @return True if the emulators write observations, false otherwise.
+    bool has_observations() const;
+
+    /// Get the size of the observation of a single emulator.
+    /// @return The size of an observation in bytes, or zero without pipeline.
+    size_t get_observation_size() const;
+
+    /// Clear the stacked frames of an emulator after it was reset or loaded.
+    /// @param index Index of the emulator.
+    void clear_observation(size_t index);
+
+    /// Get the observations, stored contiguously in emulator order.
+    /// @note The memory is shared so that it can outlive the pipelines, it is replaced
+    /// whenever a new pipeline configuration is set.
+    inline const std::shared_ptr<uint8_t[]>& get_observations() const {
+        return _observations;
+    }
+
+    /// Attach a reward function to every emulator (see `NES::set_reward_function`).
+    /// @note While reward functions are attached, the rewards and done flags of every
+    /// emulator are updated at each step.
+    /// @param reward Reward expression (see `MemoryExpression`).
+    /// @param done Termination expression.
+    void set_reward_function(const std::string& reward, const std::string& done);
+
+    /// Detach the reward functions.
+    void clear_reward_function();
+
+    /// Check whether or not reward functions are attached.
+    /// @return True if the rewards are computed, false otherwise.
+    bool has_reward_function() const;
+
+    /// Get a pointer to the rewards of the last step, stored contiguously in emulator
+    /// order.
+    /// @note The reward of a frozen emulator is zero.
+    inline const double* get_rewards() const {
+        return _rewards.get();
+    }
+
+    /// Get a pointer to the done flags of the last step, stored contiguously in
+    /// emulator order.
+    inline const bool* get_dones() const {
+        return _dones.get();
+    }
+
+    /// Enable or disable the rendering of intermediate frames for every emulator (see
+    /// `NES::set_render_skip`).
+    /// @param skip True to only render the last frame of a step, false otherwise.
+    void set_render_skip(bool skip);
+
+    /// Check whether or not intermediate frames are skipped.
+    /// @return True if only the last frame of a step is rendered, false otherwise.
+    bool get_render_skip() const;
+
+    /// Get a pointer to the frame buffers, stored contiguously in emulator order.
+    inline const uint8_t* get_frame_buffers() const {
+        return _frame_buffers.get();
+    }
+
+    /// Get a pointer to the palette index buffers, stored contiguously in emulator
+    /// order.
+    inline const uint8_t* get_index_buffers() const {
+        return _index_buffers.get();
+    }
+
+    /// Get a pointer to the scanline color emphasis bits, stored contiguously in
+    /// emulator order.
+    inline const uint8_t* get_emphasis_buffers() const {
+        return _emphasis_buffers.get();
+    }
+
+    /// Get a pointer to the frozen flags, stored contiguously in emulator order.
+    inline const bool* get_frozen_flags() const {
+        return _frozen.get();
+    }
+
+public:
+    static constexpr size_t FRAME_BUFFER_SIZE = 240 * 256 * 3;
+    static constexpr size_t INDEX_BUFFER_SIZE = 240 * 256;
+    static constexpr size_t EMPHASIS_BUFFER_SIZE = 240;
+
+private:
+    std::vector<std::unique_ptr<NES>> _emulators;
+
+    std::unique_ptr<uint8_t[]> _frame_buffers;
+    std::unique_ptr<uint8_t[]> _index_buffers;
+    std::unique_ptr<uint8_t[]> _emphasis_buffers;
+    std::unique_ptr<bool[]> _frozen;
+    std::unique_ptr<double[]> _rewards;
+    std::unique_ptr<bool[]> _dones;
+
+    FrameFormat _frame_format;
+
+    std::vector<std::unique_ptr<ObservationPipeline>> _pipelines;
+    std::shared_ptr<uint8_t[]> _observations;
+
+    std::vector<std::unique_ptr<Environment>> _environments;
+
+    ThreadPool _pool;
+
+private:
+    void load(const uint8_t* rom, size_t rom_size, size_t size);
+    void step_frames(size_t index, uint16_t controllers, unsigned int frames, uint8_t* output);
+    void copy_buffers(size_t index, bool in_place);
+};
+}
+
+#endif
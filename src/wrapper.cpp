@@ -1,16 +1,271 @@
 #include "wrapper.hpp"
+#include "environment.hpp"
 #include "nes.hpp"
+#include "observation.hpp"
+#include "vectorized.hpp"
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 #include <pybind11/cast.h>
 #include <pybind11/detail/common.h>
 #include <pybind11/pybind11.h>
 
 
+const uint8_t* get_rom_data(const pybind11::buffer_info& rom) {
+    if (rom.ndim != 1 || rom.strides[0] != rom.itemsize) {
+        throw std::runtime_error("The ROM buffer must be one-dimensional and contiguous.");
+    }
+
+    return static_cast<const uint8_t*>(rom.ptr);
+}
+
+pybind11::array_t<uint8_t> get_memory_array(
+    cynes::NES& nes,
+    cynes::MemoryRegion region,
+    pybind11::handle base
+) {
+    const uint8_t* memory = nes.get_memory(region);
+
+    if (memory == nullptr) {
+        return pybind11::array_t<uint8_t>{0};
+    }
+
+    pybind11::array_t<uint8_t> array{
+        {static_cast<pybind11::ssize_t>(nes.get_memory_size(region))},
+        {1},
+        memory,
+        base
+    };
+
+    pybind11::detail::array_proxy(array.ptr())->flags &= ~pybind11::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+
+    return array;
+}
+
+void check_memory_range(uint16_t address, size_t size) {
+    if (address + size > 0x10000) {
+        throw std::runtime_error("The memory range exceeds the console address space.");
+    }
+}
+
+std::unique_lock<std::mutex> lock_wrapper(std::mutex& mutex) {
+    std::unique_lock<std::mutex> lock{mutex, std::try_to_lock};
+
+    // The GIL is released while waiting, the thread holding the lock may need it to
+    // complete its call.
+    if (!lock.owns_lock()) {
+        pybind11::gil_scoped_release release;
+        lock.lock();
+    }
+
+    return lock;
+}
+
+size_t get_frame_size(cynes::FrameFormat format) {
+    return format == cynes::FrameFormat::PALETTE ? 240 * 256 : 240 * 256 * 3;
+}
+
+// Subset of the DLPack tensor ABI (see https://dmlc.github.io/dlpack/latest/c_api.html).
+struct DLDevice {
+    int32_t device_type;
+    int32_t device_id;
+};
+
+struct DLDataType {
+    uint8_t code;
+    uint8_t bits;
+    uint16_t lanes;
+};
+
+struct DLTensor {
+    void* data;
+    DLDevice device;
+    int32_t ndim;
+    DLDataType dtype;
+    int64_t* shape;
+    int64_t* strides;
+    uint64_t byte_offset;
+};
+
+struct DLManagedTensor {
+    DLTensor dl_tensor;
+    void* manager_ctx;
+    void (*deleter)(DLManagedTensor*);
+};
+
+constexpr int32_t DLPACK_DEVICE_CPU = 1;
+constexpr int32_t DLPACK_DEVICE_CUDA_HOST = 3;
+constexpr uint8_t DLPACK_TYPE_UINT = 1;
+
+cynes::ObservationConfig get_observation_config(
+    uint16_t width,
+    uint16_t height,
+    const cynes::wrapper::Crop& crop,
+    bool grayscale,
+    uint8_t stack,
+    bool max_pool,
+    bool channels_first
+) {
+    cynes::ObservationConfig config;
+
+    config.width = width;
+    config.height = height;
+    config.crop_top = std::get<0>(crop);
+    config.crop_bottom = std::get<1>(crop);
+    config.crop_left = std::get<2>(crop);
+    config.crop_right = std::get<3>(crop);
+    config.grayscale = grayscale;
+    config.stack = stack;
+    config.max_pool = max_pool;
+    config.layout = channels_first ? cynes::ObservationLayout::CHW : cynes::ObservationLayout::HWC;
+
+    return config;
+}
+
+cynes::EnvironmentConfig get_environment_config(
+    uint16_t frame_skip,
+    double sticky_probability,
+    uint16_t noop_max,
+    uint64_t seed
+) {
+    cynes::EnvironmentConfig config;
+
+    config.frame_skip = frame_skip;
+    config.sticky_probability = sticky_probability;
+    config.noop_max = noop_max;
+    config.seed = seed;
+
+    return config;
+}
+
+pybind11::array_t<uint8_t> get_observation_array(
+    const cynes::ObservationConfig& config,
+    const std::shared_ptr<uint8_t[]>& buffer,
+    std::vector<pybind11::ssize_t> shape
+) {
+    pybind11::ssize_t channels = (config.grayscale ? 1 : 3) * config.stack;
+
+    if (config.layout == cynes::ObservationLayout::CHW) {
+        shape.insert(shape.end(), {channels, config.height, config.width});
+    } else {
+        shape.insert(shape.end(), {config.height, config.width, channels});
+    }
+
+    pybind11::array_t<uint8_t> observation{
+        shape,
+        buffer.get(),
+        pybind11::capsule(
+            new std::shared_ptr<uint8_t[]>{buffer},
+            [](void* owner) { delete static_cast<std::shared_ptr<uint8_t[]>*>(owner); }
+        )
+    };
+
+    pybind11::detail::array_proxy(observation.ptr())->flags &= ~pybind11::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+
+    return observation;
+}
+
+
+cynes::wrapper::OutputBuffer::OutputBuffer(const pybind11::object& output, size_t size)
+    : _buffer{}
+    , _capsule{}
+    , _data{nullptr}
+{
+    size_t elements = 1;
+
+    if (PyObject_CheckBuffer(output.ptr())) {
+        _buffer = pybind11::reinterpret_borrow<pybind11::buffer>(output).request(true);
+
+        if (_buffer.itemsize != 1) {
+            throw std::runtime_error("The output buffer must be made of bytes.");
+        }
+
+        for (pybind11::ssize_t k = _buffer.ndim - 1; k >= 0; k--) {
+            if (_buffer.shape[k] != 1 && _buffer.strides[k] != static_cast<pybind11::ssize_t>(elements)) {
+                throw std::runtime_error("The output buffer must be contiguous.");
+            }
+
+            elements *= _buffer.shape[k];
+        }
+
+        _data = static_cast<uint8_t*>(_buffer.ptr);
+    } else if (pybind11::hasattr(output, "__dlpack__")) {
+        _capsule = output.attr("__dlpack__")();
+
+        auto* tensor = static_cast<DLManagedTensor*>(PyCapsule_GetPointer(_capsule.ptr(), "dltensor"));
+
+        if (tensor == nullptr) {
+            throw pybind11::error_already_set();
+        }
+
+        const DLTensor& dl_tensor = tensor->dl_tensor;
+
+        if (dl_tensor.device.device_type != DLPACK_DEVICE_CPU && dl_tensor.device.device_type != DLPACK_DEVICE_CUDA_HOST) {
+            throw std::runtime_error("The output tensor must be located in host memory.");
+        }
+
+        if (dl_tensor.dtype.code != DLPACK_TYPE_UINT || dl_tensor.dtype.bits != 8 || dl_tensor.dtype.lanes != 1) {
+            throw std::runtime_error("The output tensor must be of type uint8.");
+        }
+
+        for (int32_t k = dl_tensor.ndim - 1; k >= 0; k--) {
+            if (dl_tensor.strides != nullptr && dl_tensor.shape[k] != 1 && dl_tensor.strides[k] != static_cast<int64_t>(elements)) {
+                throw std::runtime_error("The output tensor must be contiguous.");
+            }
+
+            elements *= dl_tensor.shape[k];
+        }
+
+        _data = static_cast<uint8_t*>(dl_tensor.data) + dl_tensor.byte_offset;
+    } else {
+        throw std::runtime_error("The output must implement the buffer protocol or DLPack.");
+    }
+
+    if (elements != size) {
+        throw std::runtime_error("The output size does not match the size of the frames.");
+    }
+}
+
 cynes::wrapper::NesWrapper::NesWrapper(const char* path_rom)
+    : NesWrapper{NES{path_rom}} { }
+
+cynes::wrapper::NesWrapper::NesWrapper(pybind11::buffer rom)
+    : NesWrapper{rom.request()} { }
+
+cynes::wrapper::NesWrapper::NesWrapper(const pybind11::buffer_info& rom)
+    : NesWrapper{NES{get_rom_data(rom), static_cast<size_t>(rom.size * rom.itemsize)}} { }
+
+cynes::wrapper::NesWrapper::NesWrapper(const NesWrapper& other)
+    : NesWrapper{NES{other._nes}}
+{
+    controller = other.controller;
+    _crashed = other._crashed;
+
+    if (other._pipeline) {
+        _pipeline = std::make_unique<ObservationPipeline>(*other._pipeline);
+        _observation_buffer.reset(new uint8_t[_pipeline->size()]);
+
+        std::memcpy(_observation_buffer.get(), other._observation_buffer.get(), _pipeline->size());
+
+        _observation = get_observation_array(_pipeline->get_config(), _observation_buffer, {});
+    }
+
+    if (other._environment) {
+        _environment = std::make_unique<Environment>(*other._environment);
+    }
+}
+
+cynes::wrapper::NesWrapper::NesWrapper(NES&& nes)
     : controller{0x00}
-    , _nes{path_rom}
+    , _nes{std::move(nes)}
     , _save_state_size{_nes.size()}
     , _frame{
         {240, 256, 3},
@@ -18,32 +273,636 @@ cynes::wrapper::NesWrapper::NesWrapper(const char* path_rom)
         _nes.get_frame_buffer(),
         pybind11::capsule(_nes.get_frame_buffer(), [](void *) {})
     }
+    , _indices{
+        {240, 256},
+        {256, 1},
+        _nes.get_index_buffer(),
+        pybind11::capsule(_nes.get_index_buffer(), [](void *) {})
+    }
+    , _emphasis{
+        {240},
+        {1},
+        _nes.get_emphasis_buffer(),
+        pybind11::capsule(_nes.get_emphasis_buffer(), [](void *) {})
+    }
     , _crashed{false}
+    , _pipeline{}
+    , _observation_buffer{}
+    , _observation{}
+    , _environment{}
 {
     pybind11::detail::array_proxy(_frame.ptr())->flags &= ~pybind11::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+    pybind11::detail::array_proxy(_indices.ptr())->flags &= ~pybind11::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+    pybind11::detail::array_proxy(_emphasis.ptr())->flags &= ~pybind11::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+}
+
+std::unique_ptr<cynes::wrapper::NesWrapper> cynes::wrapper::NesWrapper::clone() const {
+    std::unique_lock<std::mutex> lock = acquire();
+
+    return std::make_unique<NesWrapper>(*this);
+}
+
+pybind11::object cynes::wrapper::NesWrapper::step(uint32_t frames) {
+    std::unique_lock<std::mutex> lock = acquire();
+
+    uint16_t controllers = controller;
+    RewardFunction* reward_function = _nes.get_reward_function();
+    bool crashed;
+
+    {
+        pybind11::gil_scoped_release release;
+
+        if (reward_function) {
+            reward_function->begin_step();
+        }
+
+        if (_pipeline) {
+            crashed = _pipeline->step(_nes, controllers, frames, _observation_buffer.get());
+        } else {
+            crashed = _nes.step(controllers, frames);
+        }
+    }
+
+    _crashed |= crashed;
+
+    return get_step_result(reward_function);
+}
+
+pybind11::object cynes::wrapper::NesWrapper::act(uint16_t action) {
+    std::unique_lock<std::mutex> lock = acquire();
+
+    if (!_environment) {
+        throw std::runtime_error("No environment is attached.");
+    }
+
+    bool crashed;
+
+    {
+        pybind11::gil_scoped_release release;
+        crashed = _environment->step(_nes, action, _pipeline.get(), _observation_buffer.get());
+    }
+
+    _crashed |= crashed;
+
+    return get_step_result(_nes.get_reward_function());
 }
 
-const pybind11::array_t<uint8_t>& cynes::wrapper::NesWrapper::step(uint32_t frames) {
-    _crashed |= _nes.step(controller, frames);
+pybind11::object cynes::wrapper::NesWrapper::noop_reset(pybind11::object state) {
+    std::unique_lock<std::mutex> lock = acquire();
+
+    if (!_environment) {
+        throw std::runtime_error("No environment is attached.");
+    }
+
+    pybind11::array_t<uint8_t> buffer;
+    uint8_t* data = nullptr;
+
+    if (!state.is_none()) {
+        buffer = state.cast<pybind11::array_t<uint8_t>>();
+        data = buffer.mutable_data();
+    }
+
+    bool crashed;
+
+    {
+        pybind11::gil_scoped_release release;
+        crashed = _environment->reset(_nes, data, _pipeline.get(), _observation_buffer.get());
+    }
+
+    _crashed = crashed;
+
+    return get_step_result(nullptr);
+}
+
+void cynes::wrapper::NesWrapper::set_environment(
+    uint16_t frame_skip,
+    double sticky_probability,
+    uint16_t noop_max,
+    uint64_t seed
+) {
+    std::unique_lock<std::mutex> lock = acquire();
+
+    _environment = std::make_unique<Environment>(get_environment_config(
+        frame_skip, sticky_probability, noop_max, seed
+    ));
+}
+
+pybind11::object cynes::wrapper::NesWrapper::get_step_result(
+    const RewardFunction* reward_function
+) const {
+    pybind11::object frame;
+
+    if (_pipeline) {
+        frame = _observation;
+    } else if (_nes.get_frame_format() == FrameFormat::PALETTE) {
+        frame = _indices;
+    } else {
+        frame = _frame;
+    }
+
+    if (!reward_function) {
+        return frame;
+    }
+
+    return pybind11::make_tuple(frame, reward_function->get_reward(), reward_function->is_done());
+}
+
+pybind11::array_t<uint8_t> cynes::wrapper::NesWrapper::get_memory_view(MemoryRegion region) {
+    return get_memory_array(_nes, region, pybind11::cast(this));
+}
+
+std::unique_lock<std::mutex> cynes::wrapper::NesWrapper::acquire() const {
+    return lock_wrapper(_mutex);
+}
+
+pybind11::object cynes::wrapper::NesWrapper::step_into(pybind11::object output, uint32_t frames) {
+    std::unique_lock<std::mutex> lock = acquire();
+
+    OutputBuffer buffer{output, _pipeline ? _pipeline->size() : get_frame_size(_nes.get_frame_format())};
+
+    uint16_t controllers = controller;
+    RewardFunction* reward_function = _nes.get_reward_function();
+    bool crashed;
+
+    {
+        pybind11::gil_scoped_release release;
+
+        if (reward_function) {
+            reward_function->begin_step();
+        }
+
+        if (_pipeline) {
+            crashed = _pipeline->step(_nes, controllers, frames, buffer.data());
+        } else {
+            _nes.set_frame_target(buffer.data());
+            crashed = _nes.step(controllers, frames);
+            _nes.set_frame_target(nullptr);
+        }
+    }
+
+    _crashed |= crashed;
+
+    if (!reward_function) {
+        return pybind11::none();
+    }
+
+    return pybind11::make_tuple(reward_function->get_reward(), reward_function->is_done());
+}
+
+const pybind11::array_t<uint8_t>& cynes::wrapper::NesWrapper::to_rgb() {
+    std::unique_lock<std::mutex> lock = acquire();
+
+    if (_nes.get_frame_format() == FrameFormat::PALETTE) {
+        pybind11::gil_scoped_release release;
+        _nes.convert_frame_buffer();
+    }
+
     return _frame;
 }
 
 pybind11::array_t<uint8_t> cynes::wrapper::NesWrapper::save() {
+    std::unique_lock<std::mutex> lock = acquire();
+
     pybind11::array_t<uint8_t> buffer{static_cast<int>(_save_state_size)};
-    _nes.save(buffer.mutable_data());
+    uint8_t* data = buffer.mutable_data();
+
+    {
+        pybind11::gil_scoped_release release;
+        _nes.save(data);
+    }
+
     return buffer;
 }
 
 void cynes::wrapper::NesWrapper::load(pybind11::array_t<uint8_t> buffer) {
-    _nes.load(buffer.mutable_data());
+    if (static_cast<size_t>(buffer.size()) != _save_state_size) {
+        throw std::runtime_error("The buffer size does not match the size of the save state.");
+    }
+
+    std::unique_lock<std::mutex> lock = acquire();
+
+    uint8_t* data = buffer.mutable_data();
+
+    {
+        pybind11::gil_scoped_release release;
+        _nes.load(data);
+    }
+
+    if (_pipeline) {
+        _pipeline->clear();
+    }
+
     _crashed = false;
 }
 
+pybind11::array_t<uint8_t> cynes::wrapper::NesWrapper::peek(uint16_t address, size_t size) const {
+    std::unique_lock<std::mutex> lock = acquire();
+
+    check_memory_range(address, size);
+
+    pybind11::array_t<uint8_t> values{static_cast<pybind11::ssize_t>(size)};
+    _nes.peek(address, values.mutable_data(), size);
+
+    return values;
+}
+
+void cynes::wrapper::NesWrapper::poke(
+    uint16_t address,
+    ByteArray values
+) {
+    std::unique_lock<std::mutex> lock = acquire();
+
+    check_memory_range(address, values.size());
+    _nes.poke(address, values.data(), values.size());
+}
+
+void cynes::wrapper::NesWrapper::reset() {
+    std::unique_lock<std::mutex> lock = acquire();
+
+    _nes.reset();
+
+    if (_pipeline) {
+        _pipeline->clear();
+    }
+}
+
+void cynes::wrapper::NesWrapper::set_observation(
+    uint16_t width,
+    uint16_t height,
+    Crop crop,
+    bool grayscale,
+    uint8_t stack,
+    bool max_pool,
+    bool channels_first
+) {
+    std::unique_lock<std::mutex> lock = acquire();
+
+    _pipeline = std::make_unique<ObservationPipeline>(get_observation_config(
+        width, height, crop, grayscale, stack, max_pool, channels_first
+    ));
+
+    _observation_buffer.reset(new uint8_t[_pipeline->size()]{});
+    _observation = get_observation_array(_pipeline->get_config(), _observation_buffer, {});
+}
+
+void cynes::wrapper::NesWrapper::clear_observation() {
+    std::unique_lock<std::mutex> lock = acquire();
+
+    _pipeline.reset();
+    _observation_buffer.reset();
+    _observation = pybind11::array_t<uint8_t>{};
+}
+
+pybind11::object cynes::wrapper::NesWrapper::get_observation() const {
+    std::unique_lock<std::mutex> lock = acquire();
+
+    if (!_pipeline) {
+        return pybind11::none();
+    }
+
+    return _observation;
+}
+
+cynes::wrapper::VectorNesWrapper::VectorNesWrapper(
+    const char* path_rom,
+    size_t size,
+    size_t threads
+)
+    : _nes{path_rom, size, threads}
+    , _save_state_size{_nes.get(0).size()}
+    , _controllers{static_cast<pybind11::ssize_t>(size)}
+    , _frames{
+        {static_cast<pybind11::ssize_t>(size), 240, 256, 3},
+        {static_cast<pybind11::ssize_t>(cynes::VectorNES::FRAME_BUFFER_SIZE), 256 * 3, 3, 1},
+        _nes.get_frame_buffers(),
+        pybind11::capsule(_nes.get_frame_buffers(), [](void *) {})
+    }
+    , _indices{
+        {static_cast<pybind11::ssize_t>(size), 240, 256},
+        {static_cast<pybind11::ssize_t>(cynes::VectorNES::INDEX_BUFFER_SIZE), 256, 1},
+        _nes.get_index_buffers(),
+        pybind11::capsule(_nes.get_index_buffers(), [](void *) {})
+    }
+    , _emphasis{
+        {static_cast<pybind11::ssize_t>(size), 240},
+        {static_cast<pybind11::ssize_t>(cynes::VectorNES::EMPHASIS_BUFFER_SIZE), 1},
+        _nes.get_emphasis_buffers(),
+        pybind11::capsule(_nes.get_emphasis_buffers(), [](void *) {})
+    }
+    , _crashed{
+        {static_cast<pybind11::ssize_t>(size)},
+        {static_cast<pybind11::ssize_t>(sizeof(bool))},
+        _nes.get_frozen_flags(),
+        pybind11::capsule(_nes.get_frozen_flags(), [](void *) {})
+    }
+    , _rewards{
+        {static_cast<pybind11::ssize_t>(size)},
+        {static_cast<pybind11::ssize_t>(sizeof(double))},
+        _nes.get_rewards(),
+        pybind11::capsule(_nes.get_rewards(), [](void *) {})
+    }
+    , _dones{
+        {static_cast<pybind11::ssize_t>(size)},
+        {static_cast<pybind11::ssize_t>(sizeof(bool))},
+        _nes.get_dones(),
+        pybind11::capsule(_nes.get_dones(), [](void *) {})
+    }
+    , _observations{}
+{
+    std::fill_n(_controllers.mutable_data(), size, uint16_t{0x00});
+
+    pybind11::detail::array_proxy(_frames.ptr())->flags &= ~pybind11::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+    pybind11::detail::array_proxy(_indices.ptr())->flags &= ~pybind11::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+    pybind11::detail::array_proxy(_emphasis.ptr())->flags &= ~pybind11::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+    pybind11::detail::array_proxy(_crashed.ptr())->flags &= ~pybind11::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+    pybind11::detail::array_proxy(_rewards.ptr())->flags &= ~pybind11::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+    pybind11::detail::array_proxy(_dones.ptr())->flags &= ~pybind11::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+}
+
+cynes::wrapper::VectorNesWrapper::VectorNesWrapper(
+    pybind11::buffer rom,
+    size_t size,
+    size_t threads
+)
+    : VectorNesWrapper{rom.request(), size, threads} { }
+
+cynes::wrapper::VectorNesWrapper::VectorNesWrapper(
+    const pybind11::buffer_info& rom,
+    size_t size,
+    size_t threads
+)
+    : _nes{get_rom_data(rom), static_cast<size_t>(rom.size * rom.itemsize), size, threads}
+    , _save_state_size{_nes.get(0).size()}
+    , _controllers{static_cast<pybind11::ssize_t>(size)}
+    , _frames{
+        {static_cast<pybind11::ssize_t>(size), 240, 256, 3},
+        {static_cast<pybind11::ssize_t>(cynes::VectorNES::FRAME_BUFFER_SIZE), 256 * 3, 3, 1},
+        _nes.get_frame_buffers(),
+        pybind11::capsule(_nes.get_frame_buffers(), [](void *) {})
+    }
+    , _indices{
+        {static_cast<pybind11::ssize_t>(size), 240, 256},
+        {static_cast<pybind11::ssize_t>(cynes::VectorNES::INDEX_BUFFER_SIZE), 256, 1},
+        _nes.get_index_buffers(),
+        pybind11::capsule(_nes.get_index_buffers(), [](void *) {})
+    }
+    , _emphasis{
+        {static_cast<pybind11::ssize_t>(size), 240},
+        {static_cast<pybind11::ssize_t>(cynes::VectorNES::EMPHASIS_BUFFER_SIZE), 1},
+        _nes.get_emphasis_buffers(),
+        pybind11::capsule(_nes.get_emphasis_buffers(), [](void *) {})
+    }
+    , _crashed{
+        {static_cast<pybind11::ssize_t>(size)},
+        {static_cast<pybind11::ssize_t>(sizeof(bool))},
+        _nes.get_frozen_flags(),
+        pybind11::capsule(_nes.get_frozen_flags(), [](void *) {})
+    }
+    , _rewards{
+        {static_cast<pybind11::ssize_t>(size)},
+        {static_cast<pybind11::ssize_t>(sizeof(double))},
+        _nes.get_rewards(),
+        pybind11::capsule(_nes.get_rewards(), [](void *) {})
+    }
+    , _dones{
+        {static_cast<pybind11::ssize_t>(size)},
+        {static_cast<pybind11::ssize_t>(sizeof(bool))},
+        _nes.get_dones(),
+        pybind11::capsule(_nes.get_dones(), [](void *) {})
+    }
+    , _observations{}
+{
+    std::fill_n(_controllers.mutable_data(), size, uint16_t{0x00});
 
-PYBIND11_MODULE(emulator, mod) {
+    pybind11::detail::array_proxy(_frames.ptr())->flags &= ~pybind11::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+    pybind11::detail::array_proxy(_indices.ptr())->flags &= ~pybind11::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+    pybind11::detail::array_proxy(_emphasis.ptr())->flags &= ~pybind11::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+    pybind11::detail::array_proxy(_crashed.ptr())->flags &= ~pybind11::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+    pybind11::detail::array_proxy(_rewards.ptr())->flags &= ~pybind11::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+    pybind11::detail::array_proxy(_dones.ptr())->flags &= ~pybind11::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+}
+
+pybind11::object cynes::wrapper::VectorNesWrapper::step(uint32_t frames) {
+    std::unique_lock<std::mutex> lock = acquire();
+
+    const uint16_t* controllers = _controllers.data();
+
+    {
+        pybind11::gil_scoped_release release;
+        _nes.step(controllers, frames);
+    }
+
+    return get_step_result();
+}
+
+pybind11::object cynes::wrapper::VectorNesWrapper::act(ActionArray actions) {
+    if (static_cast<size_t>(actions.size()) != _nes.size()) {
+        throw std::runtime_error("The number of actions does not match the number of emulators.");
+    }
+
+    std::unique_lock<std::mutex> lock = acquire();
+
+    const uint16_t* data = actions.data();
+
+    {
+        pybind11::gil_scoped_release release;
+        _nes.act(data);
+    }
+
+    return get_step_result();
+}
+
+void cynes::wrapper::VectorNesWrapper::noop_reset(size_t index, pybind11::object state) {
+    std::unique_lock<std::mutex> lock = acquire();
+
+    pybind11::array_t<uint8_t> buffer;
+    uint8_t* data = nullptr;
+
+    if (!state.is_none()) {
+        buffer = state.cast<pybind11::array_t<uint8_t>>();
+        data = buffer.mutable_data();
+    }
+
+    _nes.reset_environment(index, data);
+}
+
+void cynes::wrapper::VectorNesWrapper::set_environment(
+    uint16_t frame_skip,
+    double sticky_probability,
+    uint16_t noop_max,
+    uint64_t seed
+) {
+    std::unique_lock<std::mutex> lock = acquire();
+
+    _nes.set_environment_config(get_environment_config(
+        frame_skip, sticky_probability, noop_max, seed
+    ));
+}
+
+pybind11::object cynes::wrapper::VectorNesWrapper::get_step_result() const {
+    pybind11::object frames;
+
+    if (_nes.has_observations()) {
+        frames = _observations;
+    } else if (_nes.get_frame_format() == FrameFormat::PALETTE) {
+        frames = _indices;
+    } else {
+        frames = _frames;
+    }
+
+    if (!_nes.has_reward_function()) {
+        return frames;
+    }
+
+    return pybind11::make_tuple(frames, _rewards, _dones);
+}
+
+std::unique_lock<std::mutex> cynes::wrapper::VectorNesWrapper::acquire() const {
+    return lock_wrapper(_mutex);
+}
+
+pybind11::object cynes::wrapper::VectorNesWrapper::step_into(pybind11::object output, uint32_t frames) {
+    std::unique_lock<std::mutex> lock = acquire();
+
+    size_t size = _nes.has_observations() ? _nes.get_observation_size() : get_frame_size(_nes.get_frame_format());
+
+    OutputBuffer buffer{output, _nes.size() * size};
+    const uint16_t* controllers = _controllers.data();
+
+    {
+        pybind11::gil_scoped_release release;
+        _nes.step(controllers, frames, buffer.data());
+    }
+
+    if (!_nes.has_reward_function()) {
+        return pybind11::none();
+    }
+
+    return pybind11::make_tuple(_rewards, _dones);
+}
+
+const pybind11::array_t<uint8_t>& cynes::wrapper::VectorNesWrapper::to_rgb() {
+    std::unique_lock<std::mutex> lock = acquire();
+
+    if (_nes.get_frame_format() == FrameFormat::PALETTE) {
+        pybind11::gil_scoped_release release;
+        _nes.convert_frame_buffers();
+    }
+
+    return _frames;
+}
+
+pybind11::array_t<uint8_t> cynes::wrapper::VectorNesWrapper::save(size_t index) {
+    std::unique_lock<std::mutex> lock = acquire();
+
+    pybind11::array_t<uint8_t> buffer{static_cast<int>(_save_state_size)};
+    _nes.get(index).save(buffer.mutable_data());
+    return buffer;
+}
+
+void cynes::wrapper::VectorNesWrapper::load(
+    size_t index,
+    pybind11::array_t<uint8_t> buffer
+) {
+    if (static_cast<size_t>(buffer.size()) != _save_state_size) {
+        throw std::runtime_error("The buffer size does not match the size of the save state.");
+    }
+
+    std::unique_lock<std::mutex> lock = acquire();
+
+    _nes.get(index).load(buffer.mutable_data());
+    _nes.clear_frozen(index);
+    _nes.clear_observation(index);
+}
+
+pybind11::array_t<uint8_t> cynes::wrapper::VectorNesWrapper::peek(uint16_t address, size_t size) {
+    std::unique_lock<std::mutex> lock = acquire();
+
+    check_memory_range(address, size);
+
+    pybind11::array_t<uint8_t> values{{static_cast<pybind11::ssize_t>(_nes.size()), static_cast<pybind11::ssize_t>(size)}};
+    uint8_t* data = values.mutable_data();
+
+    for (size_t index = 0; index < _nes.size(); index++) {
+        _nes.get(index).peek(address, data + index * size, size);
+    }
+
+    return values;
+}
+
+void cynes::wrapper::VectorNesWrapper::poke(
+    size_t index,
+    uint16_t address,
+    ByteArray values
+) {
+    std::unique_lock<std::mutex> lock = acquire();
+
+    check_memory_range(address, values.size());
+    _nes.get(index).poke(address, values.data(), values.size());
+}
+
+void cynes::wrapper::VectorNesWrapper::reset(size_t index) {
+    std::unique_lock<std::mutex> lock = acquire();
+
+    _nes.get(index).reset();
+    _nes.clear_frozen(index);
+    _nes.clear_observation(index);
+}
+
+void cynes::wrapper::VectorNesWrapper::set_observation(
+    uint16_t width,
+    uint16_t height,
+    Crop crop,
+    bool grayscale,
+    uint8_t stack,
+    bool max_pool,
+    bool channels_first
+) {
+    std::unique_lock<std::mutex> lock = acquire();
+
+    ObservationConfig config = get_observation_config(
+        width, height, crop, grayscale, stack, max_pool, channels_first
+    );
+
+    _nes.set_observation_config(config);
+    _observations = get_observation_array(
+        config,
+        _nes.get_observations(),
+        {static_cast<pybind11::ssize_t>(_nes.size())}
+    );
+}
+
+void cynes::wrapper::VectorNesWrapper::clear_observation() {
+    std::unique_lock<std::mutex> lock = acquire();
+
+    _nes.clear_observation_config();
+    _observations = pybind11::array_t<uint8_t>{};
+}
+
+pybind11::object cynes::wrapper::VectorNesWrapper::get_observation() const {
+    std::unique_lock<std::mutex> lock = acquire();
+
+    if (!_nes.has_observations()) {
+        return pybind11::none();
+    }
+
+    return _observations;
+}
+
+
+PYBIND11_MODULE(emulator, mod, pybind11::mod_gil_not_used()) {
     mod.doc() = "C/C++ NES emulator with Python bindings";
 
+    pybind11::enum_<cynes::FrameFormat>(mod, "FrameFormat")
+        .value("RGB", cynes::FrameFormat::RGB, "240x256x3 RGB colors.")
+        .value("PALETTE", cynes::FrameFormat::PALETTE, "240x256 palette indices.");
+
     pybind11::class_<cynes::wrapper::NesWrapper>(mod, "NES")
+        .def(
+            pybind11::init<pybind11::buffer>(),
+            pybind11::arg("rom"),
+            "Initialize the emulator from the content of a ROM file."
+        )
         .def(
             pybind11::init<const char*>(),
             pybind11::arg("path_rom"),
@@ -62,6 +921,45 @@ PYBIND11_MODULE(emulator, mod) {
             pybind11::arg("address"),
             "Read a value in the emulator memory at the specified address."
         )
+        .def(
+            "peek",
+            &cynes::wrapper::NesWrapper::peek,
+            pybind11::arg("address"),
+            pybind11::arg("size") = 1,
+            "Read a range of the emulator memory without side effect."
+        )
+        .def(
+            "poke",
+            &cynes::wrapper::NesWrapper::poke,
+            pybind11::arg("address"),
+            pybind11::arg("values"),
+            "Write a range of the emulator memory without side effect."
+        )
+        .def_property_readonly(
+            "ram",
+            &cynes::wrapper::NesWrapper::get_ram,
+            "Read-only view of the console RAM."
+        )
+        .def_property_readonly(
+            "prg_ram",
+            &cynes::wrapper::NesWrapper::get_prg_ram,
+            "Read-only view of the mapper PRG RAM."
+        )
+        .def_property_readonly(
+            "vram",
+            &cynes::wrapper::NesWrapper::get_vram,
+            "Read-only view of the nametables and CHR RAM."
+        )
+        .def_property_readonly(
+            "oam",
+            &cynes::wrapper::NesWrapper::get_oam,
+            "Read-only view of the object attribute memory."
+        )
+        .def_property_readonly(
+            "palette",
+            &cynes::wrapper::NesWrapper::get_palette,
+            "Read-only view of the palette RAM."
+        )
         .def(
             "reset",
             &cynes::wrapper::NesWrapper::reset,
@@ -73,6 +971,18 @@ PYBIND11_MODULE(emulator, mod) {
             pybind11::arg("frames") = 1,
             "Run the emulator for the specified amount of frame."
         )
+        .def(
+            "step_into",
+            &cynes::wrapper::NesWrapper::step_into,
+            pybind11::arg("out"),
+            pybind11::arg("frames") = 1,
+            "Run the emulator for the specified amount of frame, rendering the last frame in the given buffer."
+        )
+        .def(
+            "clone",
+            &cynes::wrapper::NesWrapper::clone,
+            "Create a copy of the emulator sharing the same ROM memory."
+        )
         .def(
             "save",
             &cynes::wrapper::NesWrapper::save,
@@ -94,5 +1004,249 @@ PYBIND11_MODULE(emulator, mod) {
             &cynes::wrapper::NesWrapper::has_crashed,
             "Indicate whether the CPU crashed after hitting an invalid op-code."
         )
+        .def(
+            "to_rgb",
+            &cynes::wrapper::NesWrapper::to_rgb,
+            "Convert the palette indices of the last frame to RGB colors."
+        )
+        .def_property(
+            "frame_format",
+            &cynes::wrapper::NesWrapper::get_frame_format,
+            &cynes::wrapper::NesWrapper::set_frame_format,
+            "Format of the frames returned by `step`."
+        )
+        .def_property_readonly(
+            "emphasis",
+            &cynes::wrapper::NesWrapper::get_emphasis,
+            "Color emphasis bits of each scanline of the last frame."
+        )
+        .def(
+            "set_observation",
+            &cynes::wrapper::NesWrapper::set_observation,
+            pybind11::arg("width") = 84,
+            pybind11::arg("height") = 84,
+            pybind11::arg("crop") = cynes::wrapper::Crop{0, 0, 0, 0},
+            pybind11::arg("grayscale") = true,
+            pybind11::arg("stack") = 4,
+            pybind11::arg("max_pool") = true,
+            pybind11::arg("channels_first") = false,
+            "Attach an observation preprocessing pipeline."
+        )
+        .def(
+            "clear_observation",
+            &cynes::wrapper::NesWrapper::clear_observation,
+            "Detach the observation preprocessing pipeline."
+        )
+        .def_property_readonly(
+            "observation",
+            &cynes::wrapper::NesWrapper::get_observation,
+            "Last stacked observation, or None without pipeline."
+        )
+        .def(
+            "set_reward",
+            &cynes::wrapper::NesWrapper::set_reward,
+            pybind11::arg("reward") = "",
+            pybind11::arg("done") = "",
+            "Attach reward and termination expressions evaluated after every frame."
+        )
+        .def(
+            "clear_reward",
+            &cynes::wrapper::NesWrapper::clear_reward,
+            "Detach the reward and termination expressions."
+        )
+        .def(
+            "set_environment",
+            &cynes::wrapper::NesWrapper::set_environment,
+            pybind11::arg("frame_skip") = 4,
+            pybind11::arg("sticky_probability") = 0.0,
+            pybind11::arg("noop_max") = 0,
+            pybind11::arg("seed") = 0,
+            "Attach an environment applying action repeat, sticky actions and no-op starts."
+        )
+        .def(
+            "clear_environment",
+            &cynes::wrapper::NesWrapper::clear_environment,
+            "Detach the environment."
+        )
+        .def(
+            "act",
+            &cynes::wrapper::NesWrapper::act,
+            pybind11::arg("action"),
+            "Execute an action through the environment."
+        )
+        .def(
+            "noop_reset",
+            &cynes::wrapper::NesWrapper::noop_reset,
+            pybind11::arg("state") = pybind11::none(),
+            "Reset the emulator, or load a save state, followed by random no-op frames."
+        )
+        .def_property(
+            "render_skip",
+            &cynes::wrapper::NesWrapper::get_render_skip,
+            &cynes::wrapper::NesWrapper::set_render_skip,
+            "Only render the last frame of multi-frame steps."
+        )
         .doc() = "Headless NES emulator";
+
+    pybind11::class_<cynes::wrapper::VectorNesWrapper>(mod, "VectorNES")
+        .def(
+            pybind11::init<pybind11::buffer, size_t, size_t>(),
+            pybind11::arg("rom"),
+            pybind11::arg("size"),
+            pybind11::arg("threads") = 0,
+            "Initialize the emulators from the content of a ROM file."
+        )
+        .def(
+            pybind11::init<const char*, size_t, size_t>(),
+            pybind11::arg("path_rom"),
+            pybind11::arg("size"),
+            pybind11::arg("threads") = 0,
+            "Initialize the emulators."
+        )
+        .def(
+            "__len__",
+            &cynes::wrapper::VectorNesWrapper::size,
+            "Number of emulators."
+        )
+        .def(
+            "reset",
+            &cynes::wrapper::VectorNesWrapper::reset,
+            pybind11::arg("index"),
+            "Send a reset signal to one of the emulators."
+        )
+        .def(
+            "peek",
+            &cynes::wrapper::VectorNesWrapper::peek,
+            pybind11::arg("address"),
+            pybind11::arg("size") = 1,
+            "Read a range of the memory of every emulator without side effect."
+        )
+        .def(
+            "poke",
+            &cynes::wrapper::VectorNesWrapper::poke,
+            pybind11::arg("index"),
+            pybind11::arg("address"),
+            pybind11::arg("values"),
+            "Write a range of the memory of one of the emulators without side effect."
+        )
+        .def(
+            "step",
+            &cynes::wrapper::VectorNesWrapper::step,
+            pybind11::arg("frames") = 1,
+            "Run every emulator for the specified amount of frame."
+        )
+        .def(
+            "step_into",
+            &cynes::wrapper::VectorNesWrapper::step_into,
+            pybind11::arg("out"),
+            pybind11::arg("frames") = 1,
+            "Run every emulator for the specified amount of frame, rendering the last frames in the given buffer."
+        )
+        .def(
+            "save",
+            &cynes::wrapper::VectorNesWrapper::save,
+            pybind11::arg("index"),
+            "Dump the current state of one of the emulators into a save state."
+        )
+        .def(
+            "load",
+            &cynes::wrapper::VectorNesWrapper::load,
+            pybind11::arg("index"),
+            pybind11::arg("buffer"),
+            "Restore the state of one of the emulators from a save state."
+        )
+        .def_property_readonly(
+            "controllers",
+            &cynes::wrapper::VectorNesWrapper::get_controllers,
+            "Emulators controller states."
+        )
+        .def_property_readonly(
+            "has_crashed",
+            &cynes::wrapper::VectorNesWrapper::get_crashed,
+            "Indicate whether each CPU crashed after hitting an invalid op-code."
+        )
+        .def(
+            "to_rgb",
+            &cynes::wrapper::VectorNesWrapper::to_rgb,
+            "Convert the palette indices of the last frames to RGB colors."
+        )
+        .def_property(
+            "frame_format",
+            &cynes::wrapper::VectorNesWrapper::get_frame_format,
+            &cynes::wrapper::VectorNesWrapper::set_frame_format,
+            "Format of the frames returned by `step`."
+        )
+        .def_property_readonly(
+            "emphasis",
+            &cynes::wrapper::VectorNesWrapper::get_emphasis,
+            "Color emphasis bits of each scanline of the last frames."
+        )
+        .def(
+            "set_observation",
+            &cynes::wrapper::VectorNesWrapper::set_observation,
+            pybind11::arg("width") = 84,
+            pybind11::arg("height") = 84,
+            pybind11::arg("crop") = cynes::wrapper::Crop{0, 0, 0, 0},
+            pybind11::arg("grayscale") = true,
+            pybind11::arg("stack") = 4,
+            pybind11::arg("max_pool") = true,
+            pybind11::arg("channels_first") = false,
+            "Attach an observation preprocessing pipeline to every emulator."
+        )
+        .def(
+            "clear_observation",
+            &cynes::wrapper::VectorNesWrapper::clear_observation,
+            "Detach the observation preprocessing pipelines."
+        )
+        .def_property_readonly(
+            "observation",
+            &cynes::wrapper::VectorNesWrapper::get_observation,
+            "Last stacked observations of every emulator, or None without pipeline."
+        )
+        .def(
+            "set_reward",
+            &cynes::wrapper::VectorNesWrapper::set_reward,
+            pybind11::arg("reward") = "",
+            pybind11::arg("done") = "",
+            "Attach reward and termination expressions evaluated after every frame of every emulator."
+        )
+        .def(
+            "clear_reward",
+            &cynes::wrapper::VectorNesWrapper::clear_reward,
+            "Detach the reward and termination expressions."
+        )
+        .def(
+            "set_environment",
+            &cynes::wrapper::VectorNesWrapper::set_environment,
+            pybind11::arg("frame_skip") = 4,
+            pybind11::arg("sticky_probability") = 0.0,
+            pybind11::arg("noop_max") = 0,
+            pybind11::arg("seed") = 0,
+            "Attach an environment applying action repeat, sticky actions and no-op starts to every emulator."
+        )
+        .def(
+            "clear_environment",
+            &cynes::wrapper::VectorNesWrapper::clear_environment,
+            "Detach the environments."
+        )
+        .def(
+            "act",
+            &cynes::wrapper::VectorNesWrapper::act,
+            pybind11::arg("actions"),
+            "Execute an action on every emulator through their environments."
+        )
+        .def(
+            "noop_reset",
+            &cynes::wrapper::VectorNesWrapper::noop_reset,
+            pybind11::arg("index"),
+            pybind11::arg("state") = pybind11::none(),
+            "Reset one of the emulators, or load a save state, followed by random no-op frames."
+        )
+        .def_property(
+            "render_skip",
+            &cynes::wrapper::VectorNesWrapper::get_render_skip,
+            &cynes::wrapper::VectorNesWrapper::set_render_skip,
+            "Only render the last frame of multi-frame steps."
+        )
+        .doc() = "Batch of headless NES emulators stepped in parallel";
 }
@@ -1,34 +1,206 @@
 #ifndef __CYNES_WRAPPER__
 #define __CYNES_WRAPPER__
 
+#include "environment.hpp"
 #include "nes.hpp"
+#include "observation.hpp"
+#include "vectorized.hpp"
 
 #include <pybind11/numpy.h>
 #include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
 
 namespace cynes {
 namespace wrapper {
+/// Crop of the frame, as top, bottom, left and right margins.
+using Crop = std::tuple<uint16_t, uint16_t, uint16_t, uint16_t>;
+
+/// Contiguous byte array, converted from any compatible Python object.
+using ByteArray = pybind11::array_t<uint8_t, pybind11::array::c_style | pybind11::array::forcecast>;
+
+/// Contiguous controllers array, converted from any compatible Python object.
+using ActionArray = pybind11::array_t<uint16_t, pybind11::array::c_style | pybind11::array::forcecast>;
+
+/// Writable memory provided by a Python object, either through the buffer protocol or
+/// through DLPack.
+/// @note The object memory must be C-contiguous, made of bytes and located on the host.
+/// The exported memory stays valid as long as the instance is alive.
+class OutputBuffer {
+public:
+    /// Request the memory of a Python object.
+    /// @param output Python object exporting the memory.
+    /// @param size Expected size of the memory in bytes.
+    OutputBuffer(const pybind11::object& output, size_t size);
+
+    // Default destructor.
+    ~OutputBuffer() = default;
+
+    /// Get a pointer to the exported memory.
+    inline uint8_t* data() const { return _data; }
+
+private:
+    pybind11::buffer_info _buffer;
+    pybind11::object _capsule;
+
+    uint8_t* _data;
+};
+
 /// NES Wrapper for Python bindings.
+/// @note Different instances can be used concurrently from different threads, the calls
+/// made on a single instance from several threads are serialized.
 class NesWrapper {
 public:
     /// Initialize the emulator.
     /// @param path_rom Path to the ROM file.
     NesWrapper(const char* path_rom);
 
+    /// Initialize the emulator from a ROM stored in memory.
+    /// @param rom Buffer holding the content of the ROM file.
+    NesWrapper(pybind11::buffer rom);
+
+    /// Initialize the emulator as a copy of another emulator.
+    /// @param other Emulator to copy.
+    NesWrapper(const NesWrapper& other);
+
     // Default destructor.
     ~NesWrapper() = default;
 
+    /// Create a copy of the emulator sharing the same ROM memory.
+    /// @return The copied emulator.
+    std::unique_ptr<NesWrapper> clone() const;
+
     /// Step the emulation by the given amount of frame.
+    /// @note The GIL is released while the emulator is running.
+    /// @param frames Number of frame of the step.
+    /// @return Read-only framebuffer, or palette index buffer depending on the frame
+    /// format. If a reward function is attached, a tuple made of the frame, the reward
+    /// and the done flag of the step.
+    pybind11::object step(uint32_t frames);
+
+    /// Step the emulation by the given amount of frame, rendering the last frame directly
+    /// in a caller-provided buffer.
+    /// @note The buffer receives the frame in the current frame format, or the stacked
+    /// observation if a pipeline is attached. The frame buffer, palette index buffer and
+    /// observation returned by `NesWrapper::step` are not updated. The GIL is released
+    /// while the emulator is running.
+    /// @param output Writable buffer, implementing the buffer protocol or DLPack.
     /// @param frames Number of frame of the step.
+    /// @return A tuple made of the reward and the done flag of the step if a reward
+    /// function is attached, None otherwise.
+    pybind11::object step_into(pybind11::object output, uint32_t frames);
+
+    /// Get the last frame as RGB colors.
+    /// @note With the `FrameFormat::PALETTE` format, the palette indices are converted
+    /// in the framebuffer, the GIL is released during the conversion.
     /// @return Read-only framebuffer.
-    const pybind11::array_t<uint8_t>& step(uint32_t frames);
+    const pybind11::array_t<uint8_t>& to_rgb();
+
+    /// Get the format of the frames returned by `NesWrapper::step`.
+    inline FrameFormat get_frame_format() const {
+        std::unique_lock<std::mutex> lock = acquire();
+        return _nes.get_frame_format();
+    }
+
+    /// Set the format of the frames returned by `NesWrapper::step`.
+    /// @param format New frame format.
+    inline void set_frame_format(FrameFormat format) {
+        std::unique_lock<std::mutex> lock = acquire();
+        _nes.set_frame_format(format);
+    }
+
+    /// Get the color emphasis bits of each scanline of the last frame.
+    /// @note Only updated with the `FrameFormat::PALETTE` format.
+    /// @return Read-only emphasis array.
+    inline const pybind11::array_t<uint8_t>& get_emphasis() const { return _emphasis; }
+
+    /// Attach an observation pipeline, `NesWrapper::step` then returns the stacked
+    /// observations instead of the frame buffer.
+    /// @param width Width of the observations.
+    /// @param height Height of the observations.
+    /// @param crop Margins removed from the frame before resizing.
+    /// @param grayscale Whether or not the frames are converted to grayscale.
+    /// @param stack Number of stacked frames.
+    /// @param max_pool Whether or not the last two frames of a step are max-pooled.
+    /// @param channels_first Whether or not the channels come before the height and
+    /// width of the observations.
+    void set_observation(
+        uint16_t width,
+        uint16_t height,
+        Crop crop,
+        bool grayscale,
+        uint8_t stack,
+        bool max_pool,
+        bool channels_first
+    );
+
+    /// Detach the observation pipeline.
+    void clear_observation();
+
+    /// Get the last observation.
+    /// @return Read-only observation array, or None without pipeline.
+    pybind11::object get_observation() const;
+
+    /// Attach a reward function, `NesWrapper::step` then also returns the reward and
+    /// done flag of each step.
+    /// @param reward Reward expression, summed over the frames of a step (see
+    /// `MemoryExpression`).
+    /// @param done Termination expression.
+    inline void set_reward(const std::string& reward, const std::string& done) {
+        std::unique_lock<std::mutex> lock = acquire();
+        _nes.set_reward_function(reward, done);
+    }
+
+    /// Detach the reward function.
+    inline void clear_reward() {
+        std::unique_lock<std::mutex> lock = acquire();
+        _nes.clear_reward_function();
+    }
+
+    /// Attach an environment, executing the actions given to `NesWrapper::act`.
+    /// @param frame_skip Number of frame emulated per action.
+    /// @param sticky_probability Probability, at each frame, of repeating the previous
+    /// action.
+    /// @param noop_max Maximum number of no-op frames emulated by
+    /// `NesWrapper::noop_reset`.
+    /// @param seed Seed of the random number generator.
+    void set_environment(
+        uint16_t frame_skip,
+        double sticky_probability,
+        uint16_t noop_max,
+        uint64_t seed
+    );
+
+    /// Detach the environment.
+    inline void clear_environment() {
+        std::unique_lock<std::mutex> lock = acquire();
+        _environment.reset();
+    }
+
+    /// Execute an action through the environment (see `Environment::step`).
+    /// @note The GIL is released while the emulator is running.
+    /// @param action Controller state.
+    /// @return The same value as `NesWrapper::step`.
+    pybind11::object act(uint16_t action);
+
+    /// Reset the emulator through the environment, followed by random no-op frames
+    /// (see `Environment::reset`).
+    /// @note This function also clears the stacked observations and the crashed flag.
+    /// The GIL is released while the emulator is running.
+    /// @param state Optional save state loaded instead of resetting the console.
+    /// @return Read-only framebuffer, palette index buffer or observation.
+    pybind11::object noop_reset(pybind11::object state);
 
     /// Return a save state of the emulator.
+    /// @note The GIL is released while the state is dumped.
     /// @return Save state buffer.
     pybind11::array_t<uint8_t> save();
 
     /// Load a previous emulator state from a buffer.
-    /// @note This function also reset the crashed flag.
+    /// @note This function also reset the crashed flag. The GIL is released while the
+    /// state is loaded.
     /// @param buffer Save state buffer.
     void load(pybind11::array_t<uint8_t> buffer);
 
@@ -38,6 +210,7 @@ public:
     /// @param address Memory address within the console memory address space.
     /// @param value Value to write.
     inline void write(uint16_t address, uint8_t value) {
+        std::unique_lock<std::mutex> lock = acquire();
         _nes.write_cpu(address, value);
     }
 
@@ -46,27 +219,315 @@ public:
     /// should not be used as a memory watch function.
     /// @param address Memory address within the console memory address space.
     /// @return The value stored at the given address.
-    inline uint8_t read(uint16_t address) { return _nes.read_cpu(address); }
+    inline uint8_t read(uint16_t address) {
+        std::unique_lock<std::mutex> lock = acquire();
+        return _nes.read_cpu(address);
+    }
+
+    /// Read a range of the console memory without side effect.
+    /// @note Memory mapped registers are not read, the open bus value is returned
+    /// instead (see `NES::peek`).
+    /// @param address First memory address within the console memory address space.
+    /// @param size Number of bytes to read.
+    /// @return The values stored in the memory range.
+    pybind11::array_t<uint8_t> peek(uint16_t address, size_t size) const;
+
+    /// Write a range of the console memory without side effect.
+    /// @note Writes to memory mapped registers and to ROM are ignored (see `NES::poke`).
+    /// @param address First memory address within the console memory address space.
+    /// @param values Values to write.
+    void poke(uint16_t address, ByteArray values);
+
+    /// Get a read-only view of the console RAM (2KB).
+    inline pybind11::array_t<uint8_t> get_ram() { return get_memory_view(MemoryRegion::RAM); }
+
+    /// Get a read-only view of the mapper CPU RAM (PRG RAM).
+    inline pybind11::array_t<uint8_t> get_prg_ram() { return get_memory_view(MemoryRegion::PRG_RAM); }
+
+    /// Get a read-only view of the mapper PPU RAM (nametables and CHR RAM).
+    inline pybind11::array_t<uint8_t> get_vram() { return get_memory_view(MemoryRegion::VRAM); }
+
+    /// Get a read-only view of the object attribute memory.
+    inline pybind11::array_t<uint8_t> get_oam() { return get_memory_view(MemoryRegion::OAM); }
+
+    /// Get a read-only view of the palette RAM.
+    inline pybind11::array_t<uint8_t> get_palette() { return get_memory_view(MemoryRegion::PALETTE); }
 
     /// Reset the emulator (same effect as pressing the reset button).
-    inline void reset() { _nes.reset(); }
+    /// @note This function also clears the stacked observations.
+    void reset();
 
     /// Check whether or not the emulator has hit a JAM instruction.
     /// @note When the emulator has crashed, subsequent calls to `NesWrapper::step` will
     /// not do anything. Resetting the emulator or loading a valid save-state will reset
     /// this flag.
     /// @return True if the emulator crashed, false otherwise.
-    inline bool has_crashed() const { return _crashed; }
+    inline bool has_crashed() const {
+        std::unique_lock<std::mutex> lock = acquire();
+        return _crashed;
+    }
+
+    /// Check whether or not intermediate frames of a step are rendered.
+    /// @return True if only the last frame of a step is rendered, false otherwise.
+    inline bool get_render_skip() const {
+        std::unique_lock<std::mutex> lock = acquire();
+        return _nes.get_render_skip();
+    }
+
+    /// Enable or disable the rendering of intermediate frames of a step.
+    /// @param skip True to only render the last frame of a step, false otherwise.
+    inline void set_render_skip(bool skip) {
+        std::unique_lock<std::mutex> lock = acquire();
+        _nes.set_render_skip(skip);
+    }
 
 public:
     uint16_t controller;
 
 private:
+    NesWrapper(const pybind11::buffer_info& rom);
+
+    /// Initialize the wrapper around an emulator.
+    /// @param nes Emulator, moved into the wrapper.
+    NesWrapper(NES&& nes);
+
+    pybind11::object get_step_result(const RewardFunction* reward_function) const;
+
+    /// Get a read-only view of a memory region of the emulator.
+    /// @note The view holds a reference to the Python object of the wrapper, so that the
+    /// emulator outlives it.
+    /// @param region Memory region.
+    /// @return The view, or an empty array if the region does not exist.
+    pybind11::array_t<uint8_t> get_memory_view(MemoryRegion region);
+
+    /// Lock the wrapper for the duration of a call.
+    /// @note The GIL is released while waiting for the lock.
+    /// @return The lock, held until it is destroyed.
+    std::unique_lock<std::mutex> acquire() const;
+
+private:
+    mutable std::mutex _mutex;
+
     NES _nes;
     const size_t _save_state_size;
 
     pybind11::array_t<uint8_t> _frame;
+    pybind11::array_t<uint8_t> _indices;
+    pybind11::array_t<uint8_t> _emphasis;
     bool _crashed;
+
+    std::unique_ptr<ObservationPipeline> _pipeline;
+    std::shared_ptr<uint8_t[]> _observation_buffer;
+    pybind11::array_t<uint8_t> _observation;
+
+    std::unique_ptr<Environment> _environment;
+};
+
+/// Batched NES Wrapper for Python bindings.
+/// @note The calls made on a single instance from several threads are serialized.
+class VectorNesWrapper {
+public:
+    /// Initialize the emulators.
+    /// @param path_rom Path to the ROM file.
+    /// @param size Number of emulators.
+    /// @param threads Number of threads used to step the emulators (0 for the number of
+    /// hardware threads).
+    VectorNesWrapper(const char* path_rom, size_t size, size_t threads);
+
+    /// Initialize the emulators from a ROM stored in memory.
+    /// @param rom Buffer holding the content of the ROM file.
+    /// @param size Number of emulators.
+    /// @param threads Number of threads used to step the emulators (0 for the number of
+    /// hardware threads).
+    VectorNesWrapper(pybind11::buffer rom, size_t size, size_t threads);
+
+    // Default destructor.
+    ~VectorNesWrapper() = default;
+
+    /// Step every emulator by the given amount of frame.
+    /// @note The GIL is released while the emulators are running.
+    /// @param frames Number of frame of the step.
+    /// @return Read-only framebuffers, or palette index buffers depending on the frame
+    /// format, of every emulator. If reward functions are attached, a tuple made of the
+    /// frames, the rewards and the done flags of the step.
+    pybind11::object step(uint32_t frames);
+
+    /// Step every emulator by the given amount of frame, rendering the last frames
+    /// directly in a caller-provided buffer (see `NesWrapper::step_into`).
+    /// @note The part of the buffer belonging to a crashed emulator is left untouched.
+    /// @param output Writable buffer, implementing the buffer protocol or DLPack.
+    /// @param frames Number of frame of the step.
+    /// @return A tuple made of the rewards and the done flags of the step if reward
+    /// functions are attached, None otherwise.
+    pybind11::object step_into(pybind11::object output, uint32_t frames);
+
+    /// Get the last frame of every emulator as RGB colors.
+    /// @note With the `FrameFormat::PALETTE` format, the palette indices are converted
+    /// in the framebuffers, the GIL is released during the conversion.
+    /// @return Read-only framebuffers of every emulator.
+    const pybind11::array_t<uint8_t>& to_rgb();
+
+    /// Get the format of the frames returned by `VectorNesWrapper::step`.
+    inline FrameFormat get_frame_format() const {
+        std::unique_lock<std::mutex> lock = acquire();
+        return _nes.get_frame_format();
+    }
+
+    /// Set the format of the frames returned by `VectorNesWrapper::step`.
+    /// @param format New frame format.
+    inline void set_frame_format(FrameFormat format) {
+        std::unique_lock<std::mutex> lock = acquire();
+        _nes.set_frame_format(format);
+    }
+
+    /// Get the color emphasis bits of each scanline of the last frame of every
+    /// emulator.
+    /// @note Only updated with the `FrameFormat::PALETTE` format.
+    /// @return Read-only emphasis array.
+    inline const pybind11::array_t<uint8_t>& get_emphasis() const { return _emphasis; }
+
+    /// Attach an observation pipeline to every emulator (see
+    /// `NesWrapper::set_observation`).
+    void set_observation(
+        uint16_t width,
+        uint16_t height,
+        Crop crop,
+        bool grayscale,
+        uint8_t stack,
+        bool max_pool,
+        bool channels_first
+    );
+
+    /// Detach the observation pipelines.
+    void clear_observation();
+
+    /// Get the last observation of every emulator.
+    /// @return Read-only observations array, or None without pipeline.
+    pybind11::object get_observation() const;
+
+    /// Attach a reward function to every emulator (see `NesWrapper::set_reward`).
+    /// @param reward Reward expression.
+    /// @param done Termination expression.
+    inline void set_reward(const std::string& reward, const std::string& done) {
+        std::unique_lock<std::mutex> lock = acquire();
+        _nes.set_reward_function(reward, done);
+    }
+
+    /// Detach the reward functions.
+    inline void clear_reward() {
+        std::unique_lock<std::mutex> lock = acquire();
+        _nes.clear_reward_function();
+    }
+
+    /// Attach an environment to every emulator (see `NesWrapper::set_environment`).
+    /// @note The generator of each emulator is seeded with the seed plus its index.
+    void set_environment(
+        uint16_t frame_skip,
+        double sticky_probability,
+        uint16_t noop_max,
+        uint64_t seed
+    );
+
+    /// Detach the environments.
+    inline void clear_environment() {
+        std::unique_lock<std::mutex> lock = acquire();
+        _nes.clear_environment_config();
+    }
+
+    /// Execute an action on every emulator through their environments.
+    /// @note The GIL is released while the emulators are running.
+    /// @param actions Controller state of every emulator.
+    /// @return The same value as `VectorNesWrapper::step`.
+    pybind11::object act(ActionArray actions);
+
+    /// Reset one of the emulators through its environment (see
+    /// `NesWrapper::noop_reset`).
+    /// @param index Index of the emulator.
+    /// @param state Optional save state loaded instead of resetting the console.
+    void noop_reset(size_t index, pybind11::object state);
+
+    /// Return a save state of one of the emulators.
+    /// @param index Index of the emulator.
+    /// @return Save state buffer.
+    pybind11::array_t<uint8_t> save(size_t index);
+
+    /// Load a previous emulator state from a buffer.
+    /// @note This function also reset the crashed flag of the emulator.
+    /// @param index Index of the emulator.
+    /// @param buffer Save state buffer.
+    void load(size_t index, pybind11::array_t<uint8_t> buffer);
+
+    /// Read a range of the console memory of every emulator without side effect (see
+    /// `NesWrapper::peek`).
+    /// @param address First memory address within the console memory address space.
+    /// @param size Number of bytes to read.
+    /// @return The values stored in the memory range of each emulator.
+    pybind11::array_t<uint8_t> peek(uint16_t address, size_t size);
+
+    /// Write a range of the console memory of one of the emulators without side effect
+    /// (see `NesWrapper::poke`).
+    /// @param index Index of the emulator.
+    /// @param address First memory address within the console memory address space.
+    /// @param values Values to write.
+    void poke(size_t index, uint16_t address, ByteArray values);
+
+    /// Reset one of the emulators (same effect as pressing the reset button).
+    /// @note This function also reset the crashed flag of the emulator.
+    /// @param index Index of the emulator.
+    void reset(size_t index);
+
+    /// Get the number of emulators.
+    inline size_t size() const { return _nes.size(); }
+
+    /// Get the controllers state of every emulator.
+    /// @return Writable controllers array.
+    inline const pybind11::array_t<uint16_t>& get_controllers() const {
+        return _controllers;
+    }
+
+    /// Get the crashed flag of every emulator.
+    /// @return Read-only crashed flags array.
+    inline const pybind11::array_t<bool>& get_crashed() const { return _crashed; }
+
+    /// Check whether or not intermediate frames of a step are rendered.
+    /// @return True if only the last frame of a step is rendered, false otherwise.
+    inline bool get_render_skip() const {
+        std::unique_lock<std::mutex> lock = acquire();
+        return _nes.get_render_skip();
+    }
+
+    /// Enable or disable the rendering of intermediate frames of a step.
+    /// @param skip True to only render the last frame of a step, false otherwise.
+    inline void set_render_skip(bool skip) {
+        std::unique_lock<std::mutex> lock = acquire();
+        _nes.set_render_skip(skip);
+    }
+
+private:
+    VectorNesWrapper(const pybind11::buffer_info& rom, size_t size, size_t threads);
+
+    pybind11::object get_step_result() const;
+
+    /// Lock the wrapper for the duration of a call.
+    /// @note The GIL is released while waiting for the lock.
+    /// @return The lock, held until it is destroyed.
+    std::unique_lock<std::mutex> acquire() const;
+
+private:
+    mutable std::mutex _mutex;
+
+    VectorNES _nes;
+    const size_t _save_state_size;
+
+    pybind11::array_t<uint16_t> _controllers;
+    pybind11::array_t<uint8_t> _frames;
+    pybind11::array_t<uint8_t> _indices;
+    pybind11::array_t<uint8_t> _emphasis;
+    pybind11::array_t<bool> _crashed;
+    pybind11::array_t<double> _rewards;
+    pybind11::array_t<bool> _dones;
+
+    pybind11::array_t<uint8_t> _observations;
 };
 }
 }
@@ -0,0 +1,199 @@
+# cynes - C/C++ NES emulator with Python bindings
+# Copyright (C) 2021 - 2025  Combey Theo <https://www.gnu.org/licenses/>
+
+"""Environment tests.
+
+The environment draws its sticky actions and no-op starts from a seeded `mt19937_64`
+generator. The actions it actually executes, frame by frame, must match a reference
+model of these draws, and restoring the same state with the same seed must replay the
+same episode.
+"""
+
+from typing import Callable, List
+
+import numpy as np
+
+from cynes import NES
+
+FRAME_SKIP = 4
+STICKY_PROBABILITY = 0.25
+NOOP_MAX = 8
+SEED = 1234
+
+# Distinct consecutive actions, so that a repeated action can be told from a new one.
+ACTIONS = [(k * 29 + 7) & 0xFF for k in range(20)]
+
+# NROM program reading the first controller during the NMI and logging it at
+# $0300 + frame counter, the frame counter being stored in $01.
+PROGRAM = bytes([
+    # reset ($C000): wait for the PPU and enable the NMI
+    0x78,                   # SEI
+    0xD8,                   # CLD
+    0xA2, 0xFF,             # LDX #$FF
+    0x9A,                   # TXS
+    0x2C, 0x02, 0x20,       # BIT $2002
+    0x10, 0xFB,             # BPL $C005
+    0x2C, 0x02, 0x20,       # BIT $2002
+    0x10, 0xFB,             # BPL $C00A
+    0xA9, 0x80,             # LDA #$80
+    0x8D, 0x00, 0x20,       # STA $2000
+    0x4C, 0x14, 0xC0,       # JMP $C014
+    # nmi ($C017): read the first controller into $00
+    0xA9, 0x01,             # LDA #$01
+    0x8D, 0x16, 0x40,       # STA $4016
+    0xA9, 0x00,             # LDA #$00
+    0x8D, 0x16, 0x40,       # STA $4016
+    0xA2, 0x08,             # LDX #$08
+    0xAD, 0x16, 0x40,       # LDA $4016
+    0x4A,                   # LSR A
+    0x26, 0x00,             # ROL $00
+    0xCA,                   # DEX
+    0xD0, 0xF7,             # BNE $C023
+    # log the controller and count the frame
+    0xA5, 0x00,             # LDA $00
+    0xA6, 0x01,             # LDX $01
+    0x9D, 0x00, 0x03,       # STA $0300,X
+    0xE6, 0x01,             # INC $01
+    0x40,                   # RTI
+])
+
+
+def build_rom() -> bytes:
+    """Build a 16KB PRG / 8KB CHR NROM image running `PROGRAM`."""
+    prg = bytearray(0x4000)
+    prg[:len(PROGRAM)] = PROGRAM
+
+    # NMI ($C017), reset ($C000) and IRQ ($C035, RTI) vectors
+    prg[0x3FFA:0x4000] = bytes([0x17, 0xC0, 0x00, 0xC0, 0x35, 0xC0])
+
+    header = b"NES\x1A" + bytes([0x01, 0x01]) + bytes(10)
+
+    return header + bytes(prg) + bytes(0x2000)
+
+
+ROM = build_rom()
+
+
+class MT19937_64:
+    """Reference implementation of `std::mt19937_64`."""
+
+    MASK = (1 << 64) - 1
+
+    def __init__(self, seed: int) -> None:
+        self.state = [seed & self.MASK]
+
+        for k in range(1, 312):
+            previous = self.state[-1]
+            self.state.append((6364136223846793005 * (previous ^ (previous >> 62)) + k) & self.MASK)
+
+        self.index = 312
+
+    def __call__(self) -> int:
+        if self.index == 312:
+            for k in range(312):
+                value = (self.state[k] & 0xFFFFFFFF80000000) | (self.state[(k + 1) % 312] & 0x7FFFFFFF)
+                twisted = value >> 1
+
+                if value & 0x1:
+                    twisted ^= 0xB5026F5AA96619E9
+
+                self.state[k] = self.state[(k + 156) % 312] ^ twisted
+
+            self.index = 0
+
+        value = self.state[self.index]
+        self.index += 1
+
+        value ^= (value >> 29) & 0x5555555555555555
+        value ^= (value << 17) & 0x71D67FFFEDA60000
+        value ^= (value << 37) & 0xFFF7EEE000000000
+        value ^= value >> 43
+
+        return value & self.MASK
+
+
+def get_expected_actions(generator: Callable[[], int], actions: List[int]) -> List[int]:
+    """Model the actions executed during an episode, frame by frame.
+
+    Parameters
+    ----------
+    generator: Callable[[], int]
+        Generator of the environment, in its state before the reset.
+    actions: List[int]
+        Actions given to the environment after the reset.
+
+    Returns
+    -------
+    realized: List[int]
+        Controller state of every frame, starting with the no-op frames.
+    """
+    realized = [0x00] * (1 + generator() % NOOP_MAX)
+    previous = 0x00
+
+    for action in actions:
+        sticky = 0
+
+        while sticky < FRAME_SKIP and (generator() >> 11) / 9007199254740992.0 < STICKY_PROBABILITY:
+            sticky += 1
+
+        realized += [previous] * sticky + [action] * (FRAME_SKIP - sticky)
+
+        if sticky < FRAME_SKIP:
+            previous = action
+
+    return realized
+
+
+def run_episode(nes: NES, state, start: int) -> List[int]:
+    """Restore the state through the environment and execute `ACTIONS`.
+
+    Returns
+    -------
+    realized: List[int]
+        Controller state of every frame logged by the program.
+    """
+    nes.noop_reset(state)
+
+    for action in ACTIONS:
+        nes.act(action)
+
+    return list(nes.peek(0x0300 + start, nes[0x01] - start))
+
+
+def test_environment_realizes_seeded_actions():
+    nes = NES(ROM)
+    nes.step(4)
+
+    state = nes.save()
+    start = nes[0x01]
+
+    generator = MT19937_64(SEED)
+    first = get_expected_actions(generator, ACTIONS)
+    second = get_expected_actions(generator, ACTIONS)
+
+    assert start + max(len(first), len(second)) < 0x100
+    assert first != second
+
+    # The episode starts with 1 to `NOOP_MAX` no-op frames, and at least one step is
+    # split between the previous action and the new one.
+    noops = len(first) - len(ACTIONS) * FRAME_SKIP
+    steps = [first[noops + k:noops + k + FRAME_SKIP] for k in range(0, len(ACTIONS) * FRAME_SKIP, FRAME_SKIP)]
+
+    assert 1 <= noops <= NOOP_MAX
+    assert any(len(set(frames)) > 1 for frames in steps)
+
+    nes.set_environment(FRAME_SKIP, STICKY_PROBABILITY, NOOP_MAX, SEED)
+
+    assert run_episode(nes, state, start) == first
+    assert run_episode(nes, state, start) == second
+
+    # Attaching the environment again restarts its generator, restoring the same state
+    # then replays the first episode exactly.
+    nes.set_environment(FRAME_SKIP, STICKY_PROBABILITY, NOOP_MAX, SEED)
+    assert run_episode(nes, state, start) == first
+
+    replay = NES(ROM)
+    replay.set_environment(FRAME_SKIP, STICKY_PROBABILITY, NOOP_MAX, SEED)
+
+    assert run_episode(replay, state, start) == first
+    assert np.array_equal(replay.save(), nes.save())
@@ -0,0 +1,27 @@
+# cynes - C/C++ NES emulator with Python bindings
+# Copyright (C) 2021 - 2025  Combey Theo <https://www.gnu.org/licenses/>
+
+"""Memory view tests."""
+
+import gc
+
+from cynes import NES
+
+# 16KB PRG / 8KB CHR NROM image, the views do not need the program to run.
+ROM = b"NES\x1A" + bytes([0x01, 0x01]) + bytes(10) + bytes(0x4000) + bytes(0x2000)
+
+
+def test_memory_views_keep_emulator_alive():
+    nes = NES(ROM)
+    views = [nes.ram, nes.prg_ram, nes.vram, nes.oam, nes.palette]
+
+    for view in views:
+        assert not view.flags.writeable
+
+        if view.size:
+            assert view.base is nes
+
+    del nes
+    gc.collect()
+
+    assert len(views[0].tobytes()) == 0x800
@@ -0,0 +1,161 @@
+# cynes - C/C++ NES emulator with Python bindings
+# Copyright (C) 2021 - 2025  Combey Theo <https://www.gnu.org/licenses/>
+
+"""Concurrency tests.
+
+The GIL is released while an emulator is stepped, saved or loaded. Separate emulators
+driven from separate threads must produce exactly the same frames and states as when
+they are run one after the other, and calls made on a shared emulator are serialized.
+"""
+
+import hashlib
+from concurrent.futures import ThreadPoolExecutor
+from functools import partial
+
+import pytest
+
+from cynes import NES
+
+EMULATORS = 16
+THREADS = 8
+FRAMES = 120
+
+# NROM program polling the controller during the NMI, accumulating the inputs in RAM and
+# writing the result to the universal background color, so that both the frames and the
+# RAM depend on the inputs.
+PROGRAM = bytes([
+    # reset ($C000): wait for the PPU, enable the NMI and the rendering
+    0x78,                   # SEI
+    0xD8,                   # CLD
+    0xA2, 0xFF,             # LDX #$FF
+    0x9A,                   # TXS
+    0x2C, 0x02, 0x20,       # BIT $2002
+    0x10, 0xFB,             # BPL $C005
+    0x2C, 0x02, 0x20,       # BIT $2002
+    0x10, 0xFB,             # BPL $C00A
+    0xA9, 0x80,             # LDA #$80
+    0x8D, 0x00, 0x20,       # STA $2000
+    0xA9, 0x1E,             # LDA #$1E
+    0x8D, 0x01, 0x20,       # STA $2001
+    0x4C, 0x19, 0xC0,       # JMP $C019
+    # nmi ($C01C): read the first controller into $00
+    0xA9, 0x01,             # LDA #$01
+    0x8D, 0x16, 0x40,       # STA $4016
+    0xA9, 0x00,             # LDA #$00
+    0x8D, 0x16, 0x40,       # STA $4016
+    0xA2, 0x08,             # LDX #$08
+    0xAD, 0x16, 0x40,       # LDA $4016
+    0x4A,                   # LSR A
+    0x26, 0x00,             # ROL $00
+    0xCA,                   # DEX
+    0xD0, 0xF7,             # BNE $C028
+    # count the frames in $01 and accumulate the inputs in $02
+    0xE6, 0x01,             # INC $01
+    0xA5, 0x00,             # LDA $00
+    0x18,                   # CLC
+    0x65, 0x02,             # ADC $02
+    0x85, 0x02,             # STA $02
+    # write the accumulator to the universal background color
+    0xA9, 0x3F,             # LDA #$3F
+    0x8D, 0x06, 0x20,       # STA $2006
+    0xA9, 0x00,             # LDA #$00
+    0x8D, 0x06, 0x20,       # STA $2006
+    0xA5, 0x02,             # LDA $02
+    0x29, 0x3F,             # AND #$3F
+    0x8D, 0x07, 0x20,       # STA $2007
+    # restore the scroll
+    0xA9, 0x00,             # LDA #$00
+    0x8D, 0x05, 0x20,       # STA $2005
+    0x8D, 0x05, 0x20,       # STA $2005
+    0xA9, 0x80,             # LDA #$80
+    0x8D, 0x00, 0x20,       # STA $2000
+    0x40,                   # RTI
+])
+
+
+def build_rom() -> bytes:
+    """Build a 16KB PRG / 8KB CHR NROM image running `PROGRAM`."""
+    prg = bytearray(0x4000)
+    prg[:len(PROGRAM)] = PROGRAM
+
+    # NMI ($C01C), reset ($C000) and IRQ ($C058, RTI) vectors
+    prg[0x3FFA:0x4000] = bytes([0x1C, 0xC0, 0x00, 0xC0, 0x58, 0xC0])
+
+    header = b"NES\x1A" + bytes([0x01, 0x01]) + bytes(10)
+
+    return header + bytes(prg) + bytes(0x2000)
+
+
+@pytest.fixture(scope="module")
+def rom(tmp_path_factory) -> str:
+    path = tmp_path_factory.mktemp("roms") / "threading.nes"
+    path.write_bytes(build_rom())
+
+    return str(path)
+
+
+def run_emulator(rom: str, seed: int) -> str:
+    """Run an emulator with inputs derived from the seed.
+
+    Parameters
+    ----------
+    rom: str
+        Path to the ROM file.
+    seed: int
+        Seed of the controller inputs.
+
+    Returns
+    -------
+    digest: str
+        Hash of every frame, of the RAM and of the save states.
+    """
+    nes = NES(rom)
+    digest = hashlib.sha256()
+
+    for k in range(FRAMES):
+        nes.controller = (seed * 37 + k * 11) & 0xFF
+        digest.update(nes.step().tobytes())
+
+        if k == FRAMES // 2:
+            state = nes.save()
+
+    digest.update(bytes(nes[address] for address in range(0x800)))
+    digest.update(nes.save().tobytes())
+
+    nes.load(state)
+    digest.update(nes.step(FRAMES // 4).tobytes())
+    digest.update(nes.save().tobytes())
+
+    return digest.hexdigest()
+
+
+def test_threaded_step_matches_serial(rom):
+    serial = [run_emulator(rom, seed) for seed in range(EMULATORS)]
+
+    assert len(set(serial)) > 1
+
+    with ThreadPoolExecutor(max_workers=THREADS) as executor:
+        threaded = list(executor.map(partial(run_emulator, rom), range(EMULATORS)))
+
+    assert threaded == serial
+
+
+def test_shared_emulator_matches_serial(rom):
+    serial = NES(rom)
+    serial.controller = 0x5A
+
+    for _ in range(THREADS * FRAMES // 4):
+        serial.step()
+
+    shared = NES(rom)
+    shared.controller = 0x5A
+
+    def run(_):
+        for _ in range(FRAMES // 4):
+            shared.step()
+            shared.save()
+
+    with ThreadPoolExecutor(max_workers=THREADS) as executor:
+        list(executor.map(run, range(THREADS)))
+
+    assert shared.save().tobytes() == serial.save().tobytes()
@@ -0,0 +1,134 @@
+# cynes - C/C++ NES emulator with Python bindings
+# Copyright (C) 2021 - 2025  Combey Theo <https://www.gnu.org/licenses/>
+
+"""Batched stepping tests.
+
+A `VectorNES` must produce exactly the same frames, rewards, done flags and frozen flags
+as the same number of `NES` instances stepped one after the other, including when it
+has more emulators than threads.
+"""
+
+import numpy as np
+
+from cynes import NES, VectorNES
+
+EMULATORS = 12
+THREADS = 3
+STEPS = 40
+FRAMES = 2
+
+REWARD = "u8(0x02)"
+DONE = "u8(0x01) > 50"
+
+# NROM program polling the controller during the NMI, accumulating the inputs in RAM and
+# writing the result to the universal background color. Pressing the button read first
+# (bit 7 of the controller) jumps to a JAM instruction, which freezes the emulator.
+PROGRAM = bytes([
+    # reset ($C000): wait for the PPU, enable the NMI and the rendering
+    0x78,                   # SEI
+    0xD8,                   # CLD
+    0xA2, 0xFF,             # LDX #$FF
+    0x9A,                   # TXS
+    0x2C, 0x02, 0x20,       # BIT $2002
+    0x10, 0xFB,             # BPL $C005
+    0x2C, 0x02, 0x20,       # BIT $2002
+    0x10, 0xFB,             # BPL $C00A
+    0xA9, 0x80,             # LDA #$80
+    0x8D, 0x00, 0x20,       # STA $2000
+    0xA9, 0x1E,             # LDA #$1E
+    0x8D, 0x01, 0x20,       # STA $2001
+    0x4C, 0x19, 0xC0,       # JMP $C019
+    # nmi ($C01C): read the first controller into $00
+    0xA9, 0x01,             # LDA #$01
+    0x8D, 0x16, 0x40,       # STA $4016
+    0xA9, 0x00,             # LDA #$00
+    0x8D, 0x16, 0x40,       # STA $4016
+    0xA2, 0x08,             # LDX #$08
+    0xAD, 0x16, 0x40,       # LDA $4016
+    0x4A,                   # LSR A
+    0x26, 0x00,             # ROL $00
+    0xCA,                   # DEX
+    0xD0, 0xF7,             # BNE $C028
+    # count the frames in $01, crash if bit 7 is set, accumulate the inputs in $02
+    0xE6, 0x01,             # INC $01
+    0xA5, 0x00,             # LDA $00
+    0x30, 0x24,             # BMI $C05B
+    0x18,                   # CLC
+    0x65, 0x02,             # ADC $02
+    0x85, 0x02,             # STA $02
+    # write the accumulator to the universal background color
+    0xA9, 0x3F,             # LDA #$3F
+    0x8D, 0x06, 0x20,       # STA $2006
+    0xA9, 0x00,             # LDA #$00
+    0x8D, 0x06, 0x20,       # STA $2006
+    0xA5, 0x02,             # LDA $02
+    0x29, 0x3F,             # AND #$3F
+    0x8D, 0x07, 0x20,       # STA $2007
+    # restore the scroll
+    0xA9, 0x00,             # LDA #$00
+    0x8D, 0x05, 0x20,       # STA $2005
+    0x8D, 0x05, 0x20,       # STA $2005
+    0xA9, 0x80,             # LDA #$80
+    0x8D, 0x00, 0x20,       # STA $2000
+    0x40,                   # RTI
+    # crash ($C05B)
+    0x02,                   # JAM
+])
+
+
+def build_rom() -> bytes:
+    """Build a 16KB PRG / 8KB CHR NROM image running `PROGRAM`."""
+    prg = bytearray(0x4000)
+    prg[:len(PROGRAM)] = PROGRAM
+
+    # NMI ($C01C), reset ($C000) and IRQ ($C05A, RTI) vectors
+    prg[0x3FFA:0x4000] = bytes([0x1C, 0xC0, 0x00, 0xC0, 0x5A, 0xC0])
+
+    header = b"NES\x1A" + bytes([0x01, 0x01]) + bytes(10)
+
+    return header + bytes(prg) + bytes(0x2000)
+
+
+ROM = build_rom()
+
+
+def get_controller(index: int, step: int) -> int:
+    """Get the controller state of an emulator, every fourth emulator crashes."""
+    value = (index * 37 + step * 11) & 0x7F
+
+    if index % 4 == 3 and step == 10 + index:
+        value |= 0x80
+
+    return value
+
+
+def test_vector_step_matches_serial():
+    serial = [NES(ROM) for _ in range(EMULATORS)]
+    vector = VectorNES(ROM, EMULATORS, THREADS)
+
+    for nes in serial:
+        nes.set_reward(REWARD, DONE)
+
+    vector.set_reward(REWARD, DONE)
+
+    for step in range(STEPS):
+        results = []
+
+        for index, nes in enumerate(serial):
+            nes.controller = get_controller(index, step)
+            frame, reward, done = nes.step(FRAMES)
+            results.append((frame.copy(), reward, done))
+
+        vector.controllers[:] = [get_controller(index, step) for index in range(EMULATORS)]
+        frames, rewards, dones = vector.step(FRAMES)
+
+        for index, (frame, reward, done) in enumerate(results):
+            assert np.array_equal(frames[index], frame)
+            assert rewards[index] == reward
+            assert dones[index] == done
+
+        assert list(vector.has_crashed) == [bool(nes.has_crashed) for nes in serial]
+
+    assert any(vector.has_crashed)
+    assert not all(vector.has_crashed)
+    assert any(dones)